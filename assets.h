@@ -0,0 +1,330 @@
+/* assets.h - Assets embedded in DUMPROWS
+ *
+ * Generated by assets/embed.sh.  Do not edit; add or replace files in the assets directory and regenerate instead.
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _ASSETS_H_
+#define _ASSETS_H_
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+struct asset
+{
+  const char * name, * type;
+  unsigned long version;
+  const unsigned char * data, * gzip_data;
+  size_t size, gzip_size;
+};
+
+
+/*************
+ * Constants *
+ *************/
+
+#define ASSET_URL_MAPPING_JS "?asset=mapping.js&v=123fcc24"
+static const unsigned char ASSET_MAPPING_JS[] =
+{
+  0x2f, 0x2a, 0x20, 0x6d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x2e, 0x6a, 0x73, 0x20, 0x2d, 0x20,
+  0x4d, 0x61, 0x70, 0x20, 0x74, 0x68, 0x65, 0x20, 0x67, 0x65, 0x6f, 0x6d, 0x65, 0x74, 0x72, 0x79,
+  0x20, 0x69, 0x6e, 0x20, 0x61, 0x20, 0x44, 0x55, 0x4d, 0x50, 0x52, 0x4f, 0x57, 0x53, 0x20, 0x72,
+  0x65, 0x73, 0x75, 0x6c, 0x74, 0x73, 0x20, 0x74, 0x61, 0x62, 0x6c, 0x65, 0x20, 0x28, 0x75, 0x73,
+  0x69, 0x6e, 0x67, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x6c, 0x65, 0x74, 0x29, 0x0d, 0x0a, 0x20, 0x2a,
+  0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x43, 0x6f, 0x70, 0x79, 0x72, 0x69, 0x67, 0x68, 0x74, 0x20, 0x28,
+  0x63, 0x29, 0x20, 0x32, 0x30, 0x32, 0x31, 0x2d, 0x33, 0x20, 0x4a, 0x65, 0x66, 0x66, 0x72, 0x65,
+  0x79, 0x20, 0x50, 0x61, 0x75, 0x6c, 0x20, 0x42, 0x6f, 0x75, 0x72, 0x64, 0x69, 0x65, 0x72, 0x0d,
+  0x0a, 0x20, 0x2a, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x4c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x64,
+  0x20, 0x75, 0x6e, 0x64, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x4d, 0x49, 0x54, 0x20, 0x4c,
+  0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x2e, 0x20, 0x20, 0x54, 0x68, 0x69, 0x73, 0x20, 0x66, 0x69,
+  0x6c, 0x65, 0x20, 0x6d, 0x61, 0x79, 0x20, 0x62, 0x65, 0x20, 0x75, 0x73, 0x65, 0x64, 0x20, 0x6f,
+  0x6e, 0x6c, 0x79, 0x20, 0x69, 0x6e, 0x20, 0x63, 0x6f, 0x6d, 0x70, 0x6c, 0x69, 0x61, 0x6e, 0x63,
+  0x65, 0x20, 0x77, 0x69, 0x74, 0x68, 0x20, 0x74, 0x68, 0x69, 0x73, 0x20, 0x4c, 0x69, 0x63, 0x65,
+  0x6e, 0x73, 0x65, 0x2e, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x53, 0x6f, 0x66, 0x74, 0x77, 0x61, 0x72,
+  0x65, 0x20, 0x64, 0x69, 0x73, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x65, 0x64, 0x20, 0x75, 0x6e,
+  0x64, 0x65, 0x72, 0x20, 0x74, 0x68, 0x69, 0x73, 0x20, 0x4c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65,
+  0x20, 0x69, 0x73, 0x20, 0x70, 0x72, 0x6f, 0x76, 0x69, 0x64, 0x65, 0x64, 0x20, 0x22, 0x41, 0x53,
+  0x20, 0x49, 0x53, 0x22, 0x2c, 0x20, 0x57, 0x49, 0x54, 0x48, 0x4f, 0x55, 0x54, 0x20, 0x57, 0x41,
+  0x52, 0x52, 0x41, 0x4e, 0x54, 0x59, 0x20, 0x4f, 0x46, 0x20, 0x41, 0x4e, 0x59, 0x20, 0x4b, 0x49,
+  0x4e, 0x44, 0x2e, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x46, 0x6f, 0x72, 0x20, 0x6d, 0x6f, 0x72, 0x65,
+  0x20, 0x69, 0x6e, 0x66, 0x6f, 0x72, 0x6d, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x2c, 0x20, 0x73, 0x65,
+  0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x61, 0x63, 0x63, 0x6f, 0x6d, 0x70, 0x61, 0x6e, 0x79, 0x69,
+  0x6e, 0x67, 0x20, 0x4c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x20, 0x66, 0x69, 0x6c, 0x65, 0x20,
+  0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x6f, 0x6c, 0x6c, 0x6f, 0x77, 0x69, 0x6e, 0x67,
+  0x20, 0x55, 0x52, 0x4c, 0x3a, 0x0d, 0x0a, 0x20, 0x2a, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x20, 0x20,
+  0x68, 0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x6f, 0x70, 0x65, 0x6e, 0x73, 0x6f, 0x75, 0x72,
+  0x63, 0x65, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x6c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x73, 0x2f,
+  0x4d, 0x49, 0x54, 0x0d, 0x0a, 0x20, 0x2a, 0x2f, 0x0d, 0x0a, 0x0d, 0x0a, 0x0d, 0x0a, 0x2f, 0x2a,
+  0x20, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x20, 0x61, 0x20, 0x6d, 0x61, 0x70, 0x20, 0x61, 0x62,
+  0x6f, 0x76, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6c, 0x74, 0x73, 0x2c,
+  0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x28, 0x47, 0x65, 0x6f, 0x4a, 0x53, 0x4f,
+  0x4e, 0x29, 0x20, 0x67, 0x65, 0x6f, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x20, 0x69, 0x6e, 0x20, 0x74,
+  0x68, 0x65, 0x20, 0x67, 0x69, 0x76, 0x65, 0x6e, 0x20, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x20,
+  0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x72, 0x6f, 0x77, 0x73, 0x2e, 0x20, 0x20, 0x46, 0x65,
+  0x61, 0x74, 0x75, 0x72, 0x65, 0x73, 0x20, 0x61, 0x72, 0x65, 0x20, 0x61, 0x64, 0x64, 0x65, 0x64,
+  0x20, 0x28, 0x62, 0x79, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x61, 0x64, 0x64, 0x46, 0x65, 0x61, 0x74,
+  0x75, 0x72, 0x65, 0x73, 0x29, 0x20, 0x61, 0x73, 0x20, 0x72, 0x6f, 0x77, 0x73, 0x20, 0x61, 0x72,
+  0x72, 0x69, 0x76, 0x65, 0x2e, 0x20, 0x20, 0x54, 0x68, 0x65, 0x20, 0x70, 0x72, 0x6f, 0x70, 0x65,
+  0x72, 0x74, 0x69, 0x65, 0x73, 0x20, 0x6f, 0x66, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20, 0x66, 0x65,
+  0x61, 0x74, 0x75, 0x72, 0x65, 0x20, 0x28, 0x69, 0x2e, 0x65, 0x2e, 0x2c, 0x20, 0x74, 0x68, 0x65,
+  0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x20, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x73, 0x20, 0x69, 0x6e,
+  0x20, 0x69, 0x74, 0x73, 0x20, 0x72, 0x6f, 0x77, 0x29, 0x20, 0x61, 0x72, 0x65, 0x20, 0x73, 0x68,
+  0x6f, 0x77, 0x6e, 0x20, 0x69, 0x6e, 0x20, 0x61, 0x20, 0x70, 0x6f, 0x70, 0x75, 0x70, 0x0d, 0x0a,
+  0x20, 0x2a, 0x20, 0x77, 0x68, 0x65, 0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x65, 0x61, 0x74,
+  0x75, 0x72, 0x65, 0x20, 0x69, 0x73, 0x20, 0x63, 0x6c, 0x69, 0x63, 0x6b, 0x65, 0x64, 0x2e, 0x0d,
+  0x0a, 0x20, 0x2a, 0x2f, 0x0d, 0x0a, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x69,
+  0x6e, 0x69, 0x74, 0x4d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x28, 0x65, 0x2c, 0x20, 0x63, 0x2c,
+  0x20, 0x72, 0x2c, 0x20, 0x67, 0x29, 0x0d, 0x0a, 0x7b, 0x20, 0x76, 0x61, 0x72, 0x20, 0x64, 0x20,
+  0x3d, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x72, 0x65, 0x61, 0x74,
+  0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x64, 0x69, 0x76, 0x27, 0x29, 0x2c,
+  0x20, 0x6d, 0x2c, 0x20, 0x6c, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x64, 0x2e, 0x73, 0x74, 0x79, 0x6c,
+  0x65, 0x2e, 0x68, 0x65, 0x69, 0x67, 0x68, 0x74, 0x20, 0x3d, 0x20, 0x27, 0x36, 0x30, 0x76, 0x68,
+  0x27, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x64, 0x2e, 0x73, 0x74, 0x79, 0x6c, 0x65, 0x2e, 0x6d, 0x61,
+  0x72, 0x67, 0x69, 0x6e, 0x42, 0x6f, 0x74, 0x74, 0x6f, 0x6d, 0x20, 0x3d, 0x20, 0x27, 0x38, 0x70,
+  0x78, 0x27, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x65, 0x2e, 0x70, 0x61, 0x72, 0x65, 0x6e, 0x74, 0x4e,
+  0x6f, 0x64, 0x65, 0x2e, 0x69, 0x6e, 0x73, 0x65, 0x72, 0x74, 0x42, 0x65, 0x66, 0x6f, 0x72, 0x65,
+  0x28, 0x64, 0x2c, 0x20, 0x65, 0x29, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x2f, 0x2a, 0x20,
+  0x49, 0x66, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x6c, 0x65, 0x74, 0x20, 0x69, 0x73, 0x20, 0x73, 0x65,
+  0x72, 0x76, 0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x44, 0x55, 0x4d, 0x50, 0x52, 0x4f, 0x57, 0x53,
+  0x2c, 0x20, 0x73, 0x6f, 0x20, 0x61, 0x72, 0x65, 0x20, 0x69, 0x74, 0x73, 0x20, 0x69, 0x6d, 0x61,
+  0x67, 0x65, 0x73, 0x20, 0x28, 0x77, 0x68, 0x69, 0x63, 0x68, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x6c,
+  0x65, 0x74, 0x20, 0x77, 0x6f, 0x75, 0x6c, 0x64, 0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x77, 0x69,
+  0x73, 0x65, 0x20, 0x6c, 0x6f, 0x6f, 0x6b, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x72, 0x65, 0x6c, 0x61,
+  0x74, 0x69, 0x76, 0x65, 0x20, 0x74, 0x6f, 0x20, 0x69, 0x74, 0x73, 0x20, 0x73, 0x74, 0x79, 0x6c,
+  0x65, 0x73, 0x68, 0x65, 0x65, 0x74, 0x29, 0x2e, 0x20, 0x2a, 0x2f, 0x0d, 0x0a, 0x20, 0x20, 0x69,
+  0x66, 0x20, 0x28, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x71, 0x75, 0x65, 0x72,
+  0x79, 0x53, 0x65, 0x6c, 0x65, 0x63, 0x74, 0x6f, 0x72, 0x28, 0x27, 0x6c, 0x69, 0x6e, 0x6b, 0x5b,
+  0x68, 0x72, 0x65, 0x66, 0x5e, 0x3d, 0x22, 0x3f, 0x61, 0x73, 0x73, 0x65, 0x74, 0x3d, 0x6c, 0x65,
+  0x61, 0x66, 0x6c, 0x65, 0x74, 0x2e, 0x63, 0x73, 0x73, 0x22, 0x5d, 0x27, 0x29, 0x29, 0x20, 0x4c,
+  0x2e, 0x49, 0x63, 0x6f, 0x6e, 0x2e, 0x44, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x2e, 0x69, 0x6d,
+  0x61, 0x67, 0x65, 0x50, 0x61, 0x74, 0x68, 0x20, 0x3d, 0x20, 0x27, 0x3f, 0x61, 0x73, 0x73, 0x65,
+  0x74, 0x3d, 0x69, 0x6d, 0x61, 0x67, 0x65, 0x73, 0x2f, 0x27, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20,
+  0x20, 0x2f, 0x2a, 0x20, 0x46, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x73, 0x20, 0x61, 0x72, 0x65,
+  0x20, 0x64, 0x72, 0x61, 0x77, 0x6e, 0x20, 0x6f, 0x6e, 0x20, 0x61, 0x20, 0x63, 0x61, 0x6e, 0x76,
+  0x61, 0x73, 0x2c, 0x20, 0x77, 0x68, 0x69, 0x63, 0x68, 0x20, 0x28, 0x75, 0x6e, 0x6c, 0x69, 0x6b,
+  0x65, 0x20, 0x53, 0x56, 0x47, 0x29, 0x20, 0x72, 0x65, 0x6d, 0x61, 0x69, 0x6e, 0x73, 0x20, 0x66,
+  0x61, 0x73, 0x74, 0x20, 0x77, 0x69, 0x74, 0x68, 0x20, 0x61, 0x20, 0x67, 0x72, 0x65, 0x61, 0x74,
+  0x20, 0x6d, 0x61, 0x6e, 0x79, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x6d, 0x2e, 0x20, 0x2a,
+  0x2f, 0x0d, 0x0a, 0x20, 0x20, 0x6d, 0x20, 0x3d, 0x20, 0x4c, 0x2e, 0x6d, 0x61, 0x70, 0x28, 0x64,
+  0x2c, 0x20, 0x7b, 0x20, 0x70, 0x72, 0x65, 0x66, 0x65, 0x72, 0x43, 0x61, 0x6e, 0x76, 0x61, 0x73,
+  0x3a, 0x20, 0x74, 0x72, 0x75, 0x65, 0x20, 0x7d, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x4c, 0x2e,
+  0x74, 0x69, 0x6c, 0x65, 0x4c, 0x61, 0x79, 0x65, 0x72, 0x28, 0x27, 0x68, 0x74, 0x74, 0x70, 0x73,
+  0x3a, 0x2f, 0x2f, 0x7b, 0x73, 0x7d, 0x2e, 0x74, 0x69, 0x6c, 0x65, 0x2e, 0x6f, 0x70, 0x65, 0x6e,
+  0x73, 0x74, 0x72, 0x65, 0x65, 0x74, 0x6d, 0x61, 0x70, 0x2e, 0x6f, 0x72, 0x67, 0x2f, 0x7b, 0x7a,
+  0x7d, 0x2f, 0x7b, 0x78, 0x7d, 0x2f, 0x7b, 0x79, 0x7d, 0x2e, 0x70, 0x6e, 0x67, 0x27, 0x2c, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x7b, 0x20, 0x6d, 0x61, 0x78, 0x5a, 0x6f, 0x6f, 0x6d, 0x3a, 0x20,
+  0x31, 0x39, 0x2c, 0x20, 0x61, 0x74, 0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x69, 0x6f, 0x6e, 0x3a,
+  0x20, 0x27, 0x26, 0x63, 0x6f, 0x70, 0x79, 0x3b, 0x20, 0x3c, 0x61, 0x20, 0x68, 0x72, 0x65, 0x66,
+  0x3d, 0x22, 0x68, 0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x77, 0x77, 0x77, 0x2e, 0x6f, 0x70,
+  0x65, 0x6e, 0x73, 0x74, 0x72, 0x65, 0x65, 0x74, 0x6d, 0x61, 0x70, 0x2e, 0x6f, 0x72, 0x67, 0x2f,
+  0x63, 0x6f, 0x70, 0x79, 0x72, 0x69, 0x67, 0x68, 0x74, 0x22, 0x3e, 0x4f, 0x70, 0x65, 0x6e, 0x53,
+  0x74, 0x72, 0x65, 0x65, 0x74, 0x4d, 0x61, 0x70, 0x3c, 0x2f, 0x61, 0x3e, 0x20, 0x63, 0x6f, 0x6e,
+  0x74, 0x72, 0x69, 0x62, 0x75, 0x74, 0x6f, 0x72, 0x73, 0x27, 0x20, 0x7d, 0x29, 0x2e, 0x61, 0x64,
+  0x64, 0x54, 0x6f, 0x28, 0x6d, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x6c, 0x20, 0x3d, 0x20, 0x4c,
+  0x2e, 0x67, 0x65, 0x6f, 0x4a, 0x53, 0x4f, 0x4e, 0x28, 0x6e, 0x75, 0x6c, 0x6c, 0x2c, 0x20, 0x7b,
+  0x20, 0x6f, 0x6e, 0x45, 0x61, 0x63, 0x68, 0x46, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x3a, 0x20,
+  0x66, 0x75, 0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28, 0x66, 0x2c, 0x20, 0x6c, 0x29, 0x20,
+  0x7b, 0x20, 0x6c, 0x2e, 0x62, 0x69, 0x6e, 0x64, 0x50, 0x6f, 0x70, 0x75, 0x70, 0x28, 0x66, 0x75,
+  0x6e, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28, 0x29, 0x20, 0x7b, 0x20, 0x72, 0x65, 0x74, 0x75,
+  0x72, 0x6e, 0x20, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x50, 0x6f, 0x70, 0x75, 0x70, 0x28, 0x63,
+  0x2c, 0x20, 0x72, 0x5b, 0x66, 0x2e, 0x70, 0x72, 0x6f, 0x70, 0x65, 0x72, 0x74, 0x69, 0x65, 0x73,
+  0x5d, 0x2c, 0x20, 0x67, 0x29, 0x3b, 0x20, 0x7d, 0x29, 0x3b, 0x20, 0x7d, 0x20, 0x7d, 0x29, 0x3b,
+  0x0d, 0x0a, 0x20, 0x20, 0x6c, 0x2e, 0x61, 0x64, 0x64, 0x54, 0x6f, 0x28, 0x6d, 0x29, 0x3b, 0x0d,
+  0x0a, 0x20, 0x20, 0x6d, 0x2e, 0x66, 0x69, 0x74, 0x57, 0x6f, 0x72, 0x6c, 0x64, 0x28, 0x29, 0x3b,
+  0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x7b, 0x20, 0x6d,
+  0x61, 0x70, 0x3a, 0x20, 0x6d, 0x2c, 0x20, 0x6c, 0x61, 0x79, 0x65, 0x72, 0x3a, 0x20, 0x6c, 0x2c,
+  0x20, 0x72, 0x6f, 0x77, 0x73, 0x3a, 0x20, 0x72, 0x2c, 0x20, 0x67, 0x65, 0x6f, 0x6d, 0x65, 0x74,
+  0x72, 0x79, 0x3a, 0x20, 0x67, 0x2c, 0x20, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x3a, 0x20, 0x30, 0x2c,
+  0x20, 0x66, 0x69, 0x74, 0x74, 0x65, 0x64, 0x3a, 0x20, 0x30, 0x20, 0x7d, 0x3b, 0x0d, 0x0a, 0x7d,
+  0x0d, 0x0a, 0x0d, 0x0a, 0x2f, 0x2a, 0x20, 0x41, 0x64, 0x64, 0x20, 0x61, 0x20, 0x66, 0x65, 0x61,
+  0x74, 0x75, 0x72, 0x65, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20, 0x72, 0x6f,
+  0x77, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20, 0x68, 0x61, 0x73, 0x20, 0x61, 0x72, 0x72, 0x69, 0x76,
+  0x65, 0x64, 0x20, 0x73, 0x69, 0x6e, 0x63, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6c, 0x61, 0x73,
+  0x74, 0x20, 0x63, 0x61, 0x6c, 0x6c, 0x20, 0x28, 0x75, 0x70, 0x20, 0x74, 0x6f, 0x20, 0x61, 0x20,
+  0x62, 0x61, 0x74, 0x63, 0x68, 0x20, 0x61, 0x74, 0x20, 0x61, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x2c,
+  0x20, 0x73, 0x6f, 0x20, 0x74, 0x68, 0x61, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x61, 0x67,
+  0x65, 0x20, 0x72, 0x65, 0x6d, 0x61, 0x69, 0x6e, 0x73, 0x0d, 0x0a, 0x20, 0x2a, 0x20, 0x72, 0x65,
+  0x73, 0x70, 0x6f, 0x6e, 0x73, 0x69, 0x76, 0x65, 0x29, 0x2e, 0x20, 0x20, 0x54, 0x68, 0x65, 0x20,
+  0x6d, 0x61, 0x70, 0x20, 0x69, 0x73, 0x20, 0x66, 0x69, 0x74, 0x74, 0x65, 0x64, 0x20, 0x74, 0x6f,
+  0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x73, 0x20, 0x61, 0x66,
+  0x74, 0x65, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x69, 0x72, 0x73, 0x74, 0x20, 0x62, 0x61,
+  0x74, 0x63, 0x68, 0x2c, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x61, 0x67, 0x61, 0x69, 0x6e, 0x20, 0x6f,
+  0x6e, 0x63, 0x65, 0x20, 0x61, 0x6c, 0x6c, 0x20, 0x72, 0x6f, 0x77, 0x73, 0x20, 0x68, 0x61, 0x76,
+  0x65, 0x20, 0x62, 0x65, 0x65, 0x6e, 0x20, 0x61, 0x64, 0x64, 0x65, 0x64, 0x2e, 0x0d, 0x0a, 0x20,
+  0x2a, 0x20, 0x52, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3a, 0x20,
+  0x20, 0x74, 0x72, 0x75, 0x65, 0x20, 0x69, 0x66, 0x20, 0x72, 0x6f, 0x77, 0x73, 0x20, 0x72, 0x65,
+  0x6d, 0x61, 0x69, 0x6e, 0x20, 0x74, 0x6f, 0x20, 0x62, 0x65, 0x20, 0x61, 0x64, 0x64, 0x65, 0x64,
+  0x3b, 0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x77, 0x69, 0x73, 0x65, 0x2c, 0x20, 0x66, 0x61, 0x6c,
+  0x73, 0x65, 0x2e, 0x0d, 0x0a, 0x20, 0x2a, 0x2f, 0x0d, 0x0a, 0x66, 0x75, 0x6e, 0x63, 0x74, 0x69,
+  0x6f, 0x6e, 0x20, 0x61, 0x64, 0x64, 0x46, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x73, 0x28, 0x70,
+  0x2c, 0x20, 0x64, 0x6f, 0x6e, 0x65, 0x29, 0x0d, 0x0a, 0x7b, 0x20, 0x76, 0x61, 0x72, 0x20, 0x72,
+  0x20, 0x3d, 0x20, 0x70, 0x2e, 0x72, 0x6f, 0x77, 0x73, 0x2c, 0x20, 0x6e, 0x20, 0x3d, 0x20, 0x4d,
+  0x61, 0x74, 0x68, 0x2e, 0x6d, 0x69, 0x6e, 0x28, 0x72, 0x2e, 0x6c, 0x65, 0x6e, 0x67, 0x74, 0x68,
+  0x2c, 0x20, 0x70, 0x2e, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x20, 0x2b, 0x20, 0x35, 0x30, 0x30, 0x30,
+  0x29, 0x2c, 0x20, 0x61, 0x20, 0x3d, 0x20, 0x5b, 0x5d, 0x2c, 0x20, 0x66, 0x2c, 0x20, 0x71, 0x2c,
+  0x20, 0x69, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x28, 0x69, 0x20, 0x3d, 0x20,
+  0x70, 0x2e, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x3b, 0x20, 0x69, 0x20, 0x3c, 0x20, 0x6e, 0x3b, 0x20,
+  0x2b, 0x2b, 0x69, 0x29, 0x0d, 0x0a, 0x20, 0x20, 0x7b, 0x20, 0x74, 0x72, 0x79, 0x20, 0x7b, 0x20,
+  0x71, 0x20, 0x3d, 0x20, 0x4a, 0x53, 0x4f, 0x4e, 0x2e, 0x70, 0x61, 0x72, 0x73, 0x65, 0x28, 0x72,
+  0x5b, 0x69, 0x5d, 0x5b, 0x70, 0x2e, 0x67, 0x65, 0x6f, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x5d, 0x29,
+  0x3b, 0x20, 0x7d, 0x20, 0x63, 0x61, 0x74, 0x63, 0x68, 0x20, 0x7b, 0x20, 0x63, 0x6f, 0x6e, 0x74,
+  0x69, 0x6e, 0x75, 0x65, 0x3b, 0x20, 0x7d, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x69, 0x66, 0x20,
+  0x28, 0x71, 0x20, 0x26, 0x26, 0x20, 0x41, 0x72, 0x72, 0x61, 0x79, 0x2e, 0x69, 0x73, 0x41, 0x72,
+  0x72, 0x61, 0x79, 0x28, 0x71, 0x2e, 0x63, 0x6f, 0x6f, 0x72, 0x64, 0x69, 0x6e, 0x61, 0x74, 0x65,
+  0x73, 0x29, 0x29, 0x20, 0x61, 0x2e, 0x70, 0x75, 0x73, 0x68, 0x28, 0x7b, 0x20, 0x74, 0x79, 0x70,
+  0x65, 0x3a, 0x20, 0x27, 0x46, 0x65, 0x61, 0x74, 0x75, 0x72, 0x65, 0x27, 0x2c, 0x20, 0x67, 0x65,
+  0x6f, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x3a, 0x20, 0x71, 0x2c, 0x20, 0x70, 0x72, 0x6f, 0x70, 0x65,
+  0x72, 0x74, 0x69, 0x65, 0x73, 0x3a, 0x20, 0x69, 0x20, 0x7d, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20,
+  0x7d, 0x0d, 0x0a, 0x20, 0x20, 0x70, 0x2e, 0x6c, 0x61, 0x79, 0x65, 0x72, 0x2e, 0x61, 0x64, 0x64,
+  0x44, 0x61, 0x74, 0x61, 0x28, 0x61, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x70, 0x2e, 0x63, 0x6f,
+  0x75, 0x6e, 0x74, 0x20, 0x3d, 0x20, 0x6e, 0x3b, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x66, 0x20,
+  0x3d, 0x20, 0x28, 0x64, 0x6f, 0x6e, 0x65, 0x20, 0x26, 0x26, 0x20, 0x6e, 0x20, 0x3d, 0x3d, 0x20,
+  0x72, 0x2e, 0x6c, 0x65, 0x6e, 0x67, 0x74, 0x68, 0x29, 0x20, 0x3f, 0x20, 0x32, 0x20, 0x3a, 0x20,
+  0x31, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x69, 0x66, 0x20, 0x28, 0x70, 0x2e, 0x66, 0x69, 0x74, 0x74,
+  0x65, 0x64, 0x20, 0x3c, 0x20, 0x66, 0x20, 0x26, 0x26, 0x20, 0x70, 0x2e, 0x6c, 0x61, 0x79, 0x65,
+  0x72, 0x2e, 0x67, 0x65, 0x74, 0x4c, 0x61, 0x79, 0x65, 0x72, 0x73, 0x28, 0x29, 0x2e, 0x6c, 0x65,
+  0x6e, 0x67, 0x74, 0x68, 0x29, 0x20, 0x7b, 0x20, 0x70, 0x2e, 0x6d, 0x61, 0x70, 0x2e, 0x66, 0x69,
+  0x74, 0x42, 0x6f, 0x75, 0x6e, 0x64, 0x73, 0x28, 0x70, 0x2e, 0x6c, 0x61, 0x79, 0x65, 0x72, 0x2e,
+  0x67, 0x65, 0x74, 0x42, 0x6f, 0x75, 0x6e, 0x64, 0x73, 0x28, 0x29, 0x29, 0x3b, 0x20, 0x70, 0x2e,
+  0x66, 0x69, 0x74, 0x74, 0x65, 0x64, 0x20, 0x3d, 0x20, 0x66, 0x3b, 0x20, 0x7d, 0x0d, 0x0a, 0x20,
+  0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x6e, 0x20, 0x3c, 0x20, 0x72, 0x2e, 0x6c, 0x65,
+  0x6e, 0x67, 0x74, 0x68, 0x3b, 0x0d, 0x0a, 0x7d, 0x0d, 0x0a, 0x0d, 0x0a, 0x2f, 0x2a, 0x20, 0x43,
+  0x72, 0x65, 0x61, 0x74, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6f, 0x6e, 0x74, 0x65, 0x6e,
+  0x74, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x70, 0x6f, 0x70, 0x75, 0x70, 0x20, 0x28, 0x61, 0x20,
+  0x74, 0x61, 0x62, 0x6c, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6f, 0x6c,
+  0x75, 0x6d, 0x6e, 0x20, 0x6e, 0x61, 0x6d, 0x65, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x76, 0x61,
+  0x6c, 0x75, 0x65, 0x73, 0x20, 0x69, 0x6e, 0x20, 0x61, 0x20, 0x72, 0x6f, 0x77, 0x2c, 0x20, 0x6f,
+  0x74, 0x68, 0x65, 0x72, 0x20, 0x74, 0x68, 0x61, 0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x67, 0x65,
+  0x6f, 0x6d, 0x65, 0x74, 0x72, 0x79, 0x29, 0x2e, 0x20, 0x2a, 0x2f, 0x0d, 0x0a, 0x66, 0x75, 0x6e,
+  0x63, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x63, 0x72, 0x65, 0x61, 0x74, 0x65, 0x50, 0x6f, 0x70, 0x75,
+  0x70, 0x28, 0x63, 0x2c, 0x20, 0x76, 0x2c, 0x20, 0x67, 0x29, 0x0d, 0x0a, 0x7b, 0x20, 0x76, 0x61,
+  0x72, 0x20, 0x70, 0x20, 0x3d, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x63,
+  0x72, 0x65, 0x61, 0x74, 0x65, 0x45, 0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x74, 0x28, 0x27, 0x74, 0x61,
+  0x62, 0x6c, 0x65, 0x27, 0x29, 0x2c, 0x20, 0x6e, 0x20, 0x3d, 0x20, 0x63, 0x2e, 0x6c, 0x65, 0x6e,
+  0x67, 0x74, 0x68, 0x2c, 0x20, 0x6a, 0x2c, 0x20, 0x72, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x66, 0x6f,
+  0x72, 0x20, 0x28, 0x6a, 0x20, 0x3d, 0x20, 0x30, 0x3b, 0x20, 0x6a, 0x20, 0x3c, 0x20, 0x6e, 0x3b,
+  0x20, 0x2b, 0x2b, 0x6a, 0x29, 0x0d, 0x0a, 0x20, 0x20, 0x7b, 0x20, 0x69, 0x66, 0x20, 0x28, 0x6a,
+  0x20, 0x3d, 0x3d, 0x20, 0x67, 0x29, 0x20, 0x63, 0x6f, 0x6e, 0x74, 0x69, 0x6e, 0x75, 0x65, 0x3b,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x20, 0x3d, 0x20, 0x70, 0x2e, 0x69, 0x6e, 0x73, 0x65,
+  0x72, 0x74, 0x52, 0x6f, 0x77, 0x28, 0x29, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x2e,
+  0x69, 0x6e, 0x73, 0x65, 0x72, 0x74, 0x43, 0x65, 0x6c, 0x6c, 0x28, 0x29, 0x2e, 0x74, 0x65, 0x78,
+  0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x20, 0x3d, 0x20, 0x63, 0x5b, 0x6a, 0x5d, 0x3b,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x2e, 0x69, 0x6e, 0x73, 0x65, 0x72, 0x74, 0x43, 0x65,
+  0x6c, 0x6c, 0x28, 0x29, 0x2e, 0x74, 0x65, 0x78, 0x74, 0x43, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74,
+  0x20, 0x3d, 0x20, 0x76, 0x5b, 0x6a, 0x5d, 0x3b, 0x0d, 0x0a, 0x20, 0x20, 0x7d, 0x0d, 0x0a, 0x20,
+  0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6e, 0x20, 0x70, 0x3b, 0x0d, 0x0a, 0x7d, 0x0d, 0x0a,
+};
+static const unsigned char ASSET_MAPPING_JS_GZ[] =
+{
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x56, 0x6b, 0x6f, 0xdb, 0x36,
+  0x14, 0xfd, 0x5e, 0xa0, 0xff, 0xe1, 0x22, 0x1f, 0x6a, 0xa9, 0x55, 0xe5, 0xb4, 0xc3, 0x86, 0xcd,
+  0x8e, 0x3b, 0xa4, 0x4d, 0xdb, 0xa5, 0xcb, 0x0b, 0x71, 0xda, 0xa0, 0x0b, 0x32, 0x80, 0x96, 0x28,
+  0x8b, 0x09, 0x45, 0x2a, 0x14, 0x65, 0xc7, 0x0b, 0xf2, 0xdf, 0x77, 0x48, 0x4a, 0xb6, 0x33, 0x0c,
+  0xc3, 0x10, 0x38, 0x71, 0xc4, 0xfb, 0x3c, 0xf7, 0xdc, 0x43, 0x0d, 0x5f, 0x52, 0xc5, 0xea, 0x5a,
+  0xa8, 0x79, 0x7a, 0xd3, 0xd0, 0x6b, 0x3a, 0x66, 0x35, 0xd9, 0x92, 0xd3, 0x9c, 0xeb, 0x8a, 0x5b,
+  0xb3, 0x22, 0xa1, 0x88, 0xd1, 0xc1, 0xd7, 0xe3, 0xb3, 0xf3, 0xd3, 0xcb, 0x29, 0x19, 0xde, 0xb4,
+  0xd2, 0x36, 0x64, 0xd9, 0x4c, 0x72, 0x8a, 0xda, 0x06, 0x8e, 0x74, 0xc4, 0x59, 0x21, 0xb9, 0x8d,
+  0x9f, 0x3f, 0xa3, 0x97, 0xee, 0x43, 0x1f, 0x74, 0xbd, 0x32, 0x62, 0x5e, 0x5a, 0x8a, 0xb2, 0x98,
+  0xde, 0xee, 0xbe, 0x7d, 0xf3, 0xfa, 0x07, 0xfa, 0xc2, 0x8b, 0xc2, 0xf0, 0x15, 0x9d, 0xb1, 0x56,
+  0xd2, 0x7b, 0xdd, 0x9a, 0x5c, 0x70, 0xb3, 0x76, 0x39, 0x12, 0x19, 0x57, 0x0d, 0xcf, 0xa9, 0x55,
+  0x39, 0x37, 0xbe, 0x84, 0xe3, 0xc3, 0x8b, 0xfe, 0x71, 0x4a, 0x74, 0x51, 0x8a, 0x86, 0x0a, 0x81,
+  0xac, 0x15, 0x5b, 0xd1, 0x8c, 0x53, 0xeb, 0xac, 0xb5, 0x92, 0xbe, 0xc4, 0x4c, 0x57, 0xb5, 0x14,
+  0x4c, 0x65, 0x9c, 0x96, 0xc2, 0x96, 0xf0, 0x87, 0x75, 0xef, 0xec, 0x13, 0x4c, 0x75, 0x61, 0x97,
+  0xcc, 0x70, 0xca, 0x45, 0x63, 0x8d, 0x98, 0xb5, 0x76, 0x2b, 0xd9, 0xc6, 0x98, 0xf0, 0xb5, 0x36,
+  0x7a, 0x21, 0x72, 0x1c, 0xef, 0xec, 0x4f, 0xe9, 0x70, 0xba, 0x93, 0xd0, 0xe5, 0xe1, 0xc5, 0x6f,
+  0xa7, 0x5f, 0x2f, 0xe8, 0x72, 0xff, 0xfc, 0x7c, 0xff, 0xe4, 0xe2, 0x3b, 0x9d, 0x7e, 0xa2, 0xfd,
+  0x93, 0xef, 0xf4, 0xfb, 0xe1, 0xc9, 0x41, 0x08, 0xff, 0x49, 0x1b, 0xaa, 0x34, 0xc2, 0x0b, 0x55,
+  0x68, 0x53, 0x31, 0x2b, 0xb4, 0x4a, 0xa8, 0xe1, 0xdc, 0xb7, 0xc2, 0x32, 0x57, 0x20, 0x53, 0x2b,
+  0x0f, 0x57, 0x97, 0xc9, 0x37, 0xa3, 0x43, 0xaf, 0x85, 0x96, 0x52, 0x2f, 0xdd, 0xe9, 0xd7, 0xf3,
+  0xa3, 0xd1, 0x1a, 0x15, 0xa2, 0xd2, 0xda, 0xba, 0x19, 0x0d, 0x87, 0xba, 0x86, 0x0f, 0x40, 0xcb,
+  0x78, 0xaa, 0xcd, 0x7c, 0x28, 0x43, 0x8c, 0x66, 0x08, 0x90, 0x9c, 0xe5, 0xf0, 0xf9, 0x33, 0xf7,
+  0x33, 0x04, 0xf6, 0x86, 0x33, 0x8b, 0x8c, 0x6e, 0xac, 0xc4, 0x66, 0x7a, 0x11, 0x2a, 0xe8, 0x06,
+  0x97, 0x20, 0x53, 0xc8, 0x18, 0x7d, 0xe6, 0xfa, 0xcb, 0xf4, 0xf4, 0x24, 0x7e, 0x32, 0x6a, 0x3f,
+  0x7a, 0xb1, 0xe0, 0x0e, 0x51, 0xd9, 0x56, 0x8a, 0x74, 0x11, 0xdc, 0xf5, 0xb2, 0xc1, 0x10, 0x3e,
+  0x21, 0x76, 0x8b, 0x50, 0xe4, 0x80, 0x64, 0xb9, 0xc3, 0x28, 0x9a, 0xad, 0x7c, 0xa9, 0xf8, 0xaf,
+  0x3f, 0x8d, 0x89, 0x35, 0xde, 0x03, 0x66, 0x06, 0xc1, 0xfc, 0xf4, 0xb8, 0x83, 0xb5, 0xe6, 0xc6,
+  0x0a, 0xb8, 0x23, 0x2a, 0x67, 0x59, 0x49, 0x45, 0xf0, 0xa0, 0x48, 0xa4, 0x3c, 0x4d, 0x7c, 0x26,
+  0x8d, 0x5f, 0x86, 0x16, 0x4c, 0xb6, 0xb0, 0x43, 0x45, 0xc2, 0xfa, 0x58, 0xb1, 0x4f, 0xd9, 0x94,
+  0x7a, 0xa9, 0x02, 0x25, 0x6b, 0x5d, 0xb7, 0xb5, 0xcf, 0xbc, 0x2c, 0x79, 0x28, 0xbc, 0x8f, 0x86,
+  0x11, 0x66, 0x00, 0xe8, 0x96, 0xe7, 0x69, 0x87, 0x4d, 0xd1, 0xaa, 0xcc, 0x4d, 0x04, 0xae, 0xc2,
+  0x1e, 0x07, 0xbe, 0x47, 0x3c, 0xa1, 0x2c, 0x21, 0x93, 0xd0, 0x1c, 0xcc, 0x7d, 0x40, 0x4a, 0x43,
+  0x39, 0x4d, 0x28, 0xd7, 0x59, 0x5b, 0x71, 0x65, 0xd3, 0xcc, 0x23, 0xf9, 0x51, 0x72, 0xf7, 0x5f,
+  0x34, 0xc8, 0xc5, 0x62, 0x10, 0x27, 0x54, 0x25, 0x24, 0xc7, 0x08, 0x4b, 0x79, 0xda, 0xd8, 0x95,
+  0xe4, 0x69, 0xc9, 0x3d, 0xd3, 0x27, 0x34, 0xf8, 0x69, 0x77, 0x51, 0x0e, 0x9e, 0x9c, 0x55, 0xcc,
+  0xcc, 0x85, 0x7a, 0xaf, 0xad, 0xd5, 0x95, 0xb3, 0xf8, 0xb9, 0xbe, 0x0f, 0x06, 0x3c, 0xad, 0xd1,
+  0x8f, 0xb2, 0x27, 0x3a, 0xe7, 0xa9, 0xc0, 0x24, 0x8d, 0x7d, 0xcf, 0x31, 0x1a, 0x1e, 0xe5, 0x09,
+  0xf1, 0x78, 0xec, 0x86, 0x49, 0x84, 0x71, 0x1e, 0x16, 0xfd, 0x7a, 0xb9, 0xb6, 0x60, 0xb7, 0x00,
+  0xe6, 0xb3, 0xd5, 0x7a, 0x23, 0xc1, 0x31, 0xed, 0xa1, 0x71, 0x38, 0x89, 0x8a, 0xcd, 0x81, 0x5a,
+  0xb4, 0x2c, 0x05, 0xc0, 0xed, 0xfd, 0x96, 0xba, 0x95, 0x79, 0xc0, 0x75, 0x29, 0xc0, 0x3b, 0xa9,
+  0xf5, 0xad, 0xa7, 0x81, 0xe1, 0x12, 0x3c, 0x75, 0x04, 0xd1, 0xde, 0xdd, 0xd7, 0xdc, 0x94, 0x1c,
+  0xab, 0x9c, 0x7a, 0xd8, 0x88, 0x44, 0x41, 0xd1, 0x1a, 0x90, 0xbb, 0x96, 0x9b, 0xd5, 0x94, 0x4b,
+  0x9e, 0x59, 0x6d, 0xa2, 0x81, 0x14, 0xea, 0xf6, 0xaa, 0x34, 0xbc, 0xf8, 0x73, 0xb2, 0xf3, 0x2b,
+  0x6b, 0x1a, 0x6e, 0x27, 0x32, 0xa4, 0x4c, 0xb3, 0xa6, 0xd9, 0xb9, 0x1e, 0xc4, 0x31, 0x1d, 0xa5,
+  0x87, 0x99, 0x56, 0xe9, 0x01, 0x2f, 0xb0, 0xf5, 0x36, 0xf5, 0x05, 0x9e, 0x31, 0x2c, 0x28, 0xc0,
+  0xe8, 0x7c, 0x42, 0xd1, 0xc3, 0xc1, 0xa6, 0xe7, 0x27, 0x2c, 0xcb, 0x0d, 0xc3, 0xc8, 0xb5, 0x1b,
+  0x79, 0xc6, 0xd4, 0x82, 0x81, 0xc2, 0xa1, 0xbd, 0xa8, 0x55, 0x52, 0xdc, 0x72, 0x9a, 0x7e, 0xfb,
+  0x1c, 0xa3, 0x95, 0x8a, 0x01, 0x46, 0x2a, 0x58, 0x63, 0x83, 0x02, 0x30, 0x9a, 0xbb, 0xf9, 0x61,
+  0x0d, 0xd4, 0xaa, 0x63, 0x71, 0xd5, 0x77, 0xe5, 0x66, 0x71, 0x84, 0xe1, 0xd4, 0x0e, 0xed, 0x07,
+  0x10, 0x93, 0x17, 0xdc, 0x7c, 0xf0, 0xd1, 0x47, 0x64, 0x4d, 0xcb, 0xe9, 0x31, 0xf6, 0x63, 0x3a,
+  0x4a, 0x2d, 0x96, 0xf4, 0x88, 0xad, 0x38, 0xfa, 0xed, 0x57, 0xf1, 0xa1, 0x79, 0xf4, 0x8f, 0x53,
+  0xbf, 0x93, 0xd6, 0x00, 0x2f, 0x84, 0xf2, 0x6b, 0xf9, 0xf0, 0xd7, 0xe3, 0xf0, 0xe1, 0x1e, 0x9f,
+  0xd5, 0x63, 0x5a, 0xab, 0xf9, 0x20, 0x71, 0x41, 0x08, 0x29, 0x2a, 0x76, 0xff, 0x87, 0xd6, 0xd5,
+  0x88, 0xde, 0xfc, 0x92, 0x10, 0xb3, 0x41, 0x80, 0x40, 0xc8, 0x11, 0x0d, 0x5e, 0x64, 0x50, 0xcb,
+  0x31, 0xed, 0x31, 0x72, 0x58, 0x4e, 0x76, 0xfa, 0x34, 0xcb, 0xe5, 0xf2, 0x5f, 0x32, 0x64, 0xbd,
+  0xb4, 0xee, 0xbc, 0x3b, 0xc5, 0xe1, 0xd4, 0x1f, 0x82, 0xd1, 0x7b, 0x43, 0xf6, 0x0e, 0x3b, 0xab,
+  0x42, 0x64, 0x6d, 0x9a, 0x01, 0x7a, 0x48, 0xb1, 0x94, 0x17, 0x3a, 0xaa, 0x42, 0x33, 0xd2, 0x77,
+  0x3d, 0x0f, 0x6b, 0x1f, 0xa9, 0x56, 0x4a, 0xd7, 0xbc, 0x56, 0x1f, 0xb1, 0x89, 0x1d, 0xe4, 0x23,
+  0x5a, 0x6f, 0x4a, 0x54, 0x80, 0xe8, 0x31, 0x0c, 0x64, 0x3a, 0x13, 0x2a, 0x3f, 0x73, 0xeb, 0x16,
+  0x6d, 0x4e, 0xdd, 0x89, 0xe1, 0xf0, 0x81, 0x52, 0xf8, 0x3d, 0x09, 0x06, 0x6e, 0xa1, 0xae, 0x8a,
+  0x74, 0xb3, 0xea, 0xd7, 0x6e, 0xbd, 0xc6, 0x0e, 0x4f, 0x7a, 0xec, 0x51, 0x95, 0x4f, 0xeb, 0xaa,
+  0xd2, 0x42, 0xd8, 0x4b, 0x6d, 0x64, 0x1e, 0xf5, 0xc4, 0xef, 0x22, 0x3b, 0xdc, 0xea, 0x91, 0x5f,
+  0x39, 0x37, 0x82, 0x11, 0xa1, 0x62, 0xa7, 0x2b, 0x23, 0xbf, 0xb5, 0x9d, 0x6c, 0x8d, 0x68, 0x8e,
+  0x45, 0xd6, 0xad, 0xb2, 0x23, 0xda, 0x85, 0xbe, 0x09, 0x0b, 0x65, 0xc7, 0x57, 0x7a, 0x44, 0xb0,
+  0xc7, 0x4e, 0x15, 0xf7, 0xf3, 0x1c, 0x8c, 0xe8, 0x05, 0xc2, 0x91, 0xdf, 0xeb, 0x0f, 0x82, 0x81,
+  0x18, 0x60, 0x49, 0xc9, 0x7a, 0xb1, 0xca, 0x09, 0x77, 0x5a, 0x16, 0x44, 0x53, 0x3a, 0x36, 0x65,
+  0x4c, 0x4a, 0x90, 0xad, 0x76, 0x5b, 0xc2, 0x68, 0xc6, 0x2c, 0xfc, 0xe0, 0xc1, 0xc8, 0x8a, 0x8a,
+  0xfb, 0xf5, 0xf3, 0x11, 0x9c, 0x7d, 0x0d, 0x26, 0xf7, 0x54, 0xf4, 0xd2, 0x04, 0x12, 0xd7, 0x5a,
+  0x35, 0x08, 0x1b, 0x77, 0x22, 0xe8, 0x54, 0xd9, 0x5f, 0x64, 0xae, 0x4a, 0x17, 0x72, 0x4b, 0xb8,
+  0x50, 0x42, 0x61, 0xbb, 0xcb, 0xaf, 0x10, 0x06, 0xb9, 0x7d, 0x36, 0x10, 0x46, 0xa1, 0xfa, 0x39,
+  0xa2, 0x62, 0x5a, 0x28, 0xcd, 0x15, 0xe4, 0xe5, 0xb5, 0x64, 0x58, 0xde, 0x19, 0x87, 0xfc, 0x79,
+  0x2d, 0x0e, 0x37, 0xd1, 0x79, 0xc0, 0xee, 0x9b, 0x53, 0xd0, 0x11, 0x05, 0x3a, 0x63, 0x8d, 0xbd,
+  0x43, 0xa8, 0xcd, 0xa5, 0x9d, 0x75, 0xfa, 0x3d, 0xde, 0x08, 0x03, 0xb0, 0x63, 0xb2, 0xbb, 0x2e,
+  0xb7, 0x35, 0x73, 0x4b, 0xd9, 0xa3, 0x3a, 0x81, 0x3e, 0x2a, 0xbe, 0x16, 0x4c, 0x03, 0x4e, 0xd5,
+  0xa9, 0x8b, 0x9d, 0x90, 0xc2, 0xf7, 0x63, 0xec, 0x76, 0x5a, 0x09, 0x15, 0x99, 0x54, 0x72, 0x35,
+  0xb7, 0x28, 0xbe, 0x4e, 0xfd, 0x70, 0xe8, 0x15, 0xfd, 0xb8, 0xbb, 0xbb, 0x0b, 0x05, 0x65, 0xb0,
+  0xbb, 0x02, 0x2f, 0x40, 0xb0, 0xbb, 0x84, 0x84, 0xe7, 0x80, 0x9b, 0x48, 0x24, 0x7c, 0x30, 0x6f,
+  0x3d, 0x26, 0x41, 0x7b, 0xa4, 0xc6, 0xf4, 0xea, 0x95, 0x70, 0xef, 0x15, 0xa0, 0x82, 0xbb, 0xa1,
+  0x1e, 0xe8, 0x0e, 0x36, 0x8e, 0xbf, 0x4e, 0x3f, 0x1b, 0x1e, 0x99, 0x2b, 0x71, 0x7d, 0x55, 0xa7,
+  0x3d, 0x17, 0xae, 0x3d, 0xcd, 0x32, 0x3f, 0xa3, 0x07, 0xbf, 0x0e, 0x42, 0xb5, 0x1c, 0xcf, 0xc2,
+  0x1e, 0x3a, 0x35, 0xbb, 0xa3, 0x17, 0x2f, 0x68, 0xdf, 0x18, 0xb6, 0x4a, 0x45, 0xe3, 0xff, 0x46,
+  0x77, 0xc8, 0xa9, 0xf1, 0x3a, 0xa2, 0x40, 0xe3, 0x06, 0xa2, 0xc5, 0xd2, 0xba, 0x6d, 0xca, 0x08,
+  0x29, 0x57, 0x35, 0x20, 0x1c, 0x74, 0xdd, 0x0f, 0xb6, 0x39, 0x87, 0xca, 0x37, 0x24, 0x1f, 0xa1,
+  0xda, 0x8e, 0xdb, 0x3e, 0x53, 0x9d, 0x7a, 0xbe, 0x3a, 0x9a, 0x1f, 0x30, 0xcb, 0x22, 0x16, 0xce,
+  0x7a, 0x24, 0x26, 0x68, 0x2c, 0xf0, 0xbc, 0xc0, 0xf7, 0xc8, 0x01, 0xea, 0x8a, 0x02, 0x7e, 0x13,
+  0xea, 0x71, 0x8b, 0xe9, 0x57, 0x7a, 0x4b, 0xd0, 0x8b, 0x71, 0x2f, 0xc3, 0x75, 0xda, 0x91, 0x66,
+  0x0f, 0x6e, 0x30, 0xef, 0x93, 0xcc, 0xb9, 0xf5, 0x02, 0xd5, 0x44, 0xf1, 0xda, 0x17, 0x9a, 0xe6,
+  0xe4, 0xcd, 0x79, 0xe0, 0x4d, 0x4b, 0xe5, 0x18, 0xdc, 0xc6, 0xba, 0x7b, 0x12, 0x03, 0xab, 0x75,
+  0xcc, 0x09, 0x15, 0x1d, 0x4a, 0xdd, 0xea, 0x29, 0xa4, 0xe9, 0x6b, 0xd9, 0xda, 0xa3, 0xee, 0xed,
+  0xc2, 0x31, 0xd4, 0xa1, 0x8b, 0x5b, 0xc1, 0x69, 0x6b, 0x77, 0x1b, 0x53, 0xc4, 0xba, 0x17, 0xc3,
+  0xee, 0xad, 0xa1, 0x7b, 0x87, 0x50, 0xac, 0x72, 0xdc, 0x06, 0x89, 0x37, 0xd7, 0x3a, 0x73, 0x84,
+  0x4c, 0xba, 0xdb, 0x1e, 0x0b, 0xa4, 0x9e, 0xbc, 0x75, 0x76, 0xf7, 0xcf, 0x9a, 0x82, 0xff, 0x90,
+  0x98, 0xc5, 0xf6, 0x9d, 0x5d, 0xff, 0xc7, 0x9d, 0xed, 0xab, 0x71, 0xb7, 0xb6, 0xe3, 0x66, 0xb6,
+  0xa6, 0xe4, 0x0d, 0x64, 0x64, 0x43, 0xbb, 0x1b, 0x9c, 0xed, 0x8e, 0xe9, 0xa6, 0x27, 0xdc, 0x4d,
+  0x47, 0x38, 0x07, 0xfa, 0x8d, 0x9b, 0xc9, 0x3c, 0xde, 0x50, 0x29, 0x10, 0x29, 0xd0, 0x3e, 0xdc,
+  0xdb, 0xe7, 0x7a, 0x19, 0xc5, 0xfd, 0xf3, 0xee, 0xd9, 0x07, 0x2e, 0x25, 0xc6, 0x61, 0xf9, 0xbd,
+  0xfd, 0xd0, 0xc1, 0x84, 0xfc, 0x57, 0x37, 0xd7, 0xff, 0xc7, 0x6e, 0xd1, 0xdb, 0x6d, 0xcf, 0xa3,
+  0x0e, 0x43, 0xf8, 0x1b, 0x54, 0xaf, 0x7f, 0x91, 0xaf, 0x0b, 0x00, 0x00,
+};
+
+static const struct asset ASSETS[] =
+{
+  { "mapping.js", "text/javascript", 0x123fcc24UL, ASSET_MAPPING_JS, ASSET_MAPPING_JS_GZ, sizeof(ASSET_MAPPING_JS), sizeof(ASSET_MAPPING_JS_GZ) },
+};
+
+#define ASSET_COUNT (sizeof(ASSETS) / sizeof(ASSETS[0]))
+
+
+#endif  /* (prevent multiple inclusion) */
@@ -0,0 +1,118 @@
+#!/bin/sh
+# embed.sh - Generate assets.h (the assets embedded in DUMPROWS) from the files in this directory
+#
+# Copyright (c) 2021-3 Jeffrey Paul Bourdier
+#
+# Licensed under the MIT License.  This file may be used only in compliance with this License.
+# Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+# For more information, see the accompanying License file or the following URL:
+#
+#   https://opensource.org/licenses/MIT
+#
+# Usage:  sh assets/embed.sh > assets.h
+#
+# Every file in this directory (and its subdirectories), other than this script, is embedded.  Text assets (scripts and
+# stylesheets) are also embedded precompressed (gzip), if that makes them smaller.  Each asset is versioned by its CRC
+# (from cksum), and a macro ASSET_URL_<NAME> (e.g., ASSET_URL_LEAFLET_JS) gives the versioned URL that refers to it.
+# Leaflet (leaflet.js, leaflet.css, and the images directory) is downloaded into this directory first, unless it is here.
+
+LEAFLET_VERSION=1.7.1
+
+cd "$(dirname "$0")" || exit 1
+TMP="${TMPDIR:-/tmp}/embed.$$.gz"
+trap 'rm -f "$TMP"' EXIT
+
+if [ ! -f leaflet.js ] || [ ! -f leaflet.css ] || [ ! -d images ]
+then
+  curl -fsSL "https://registry.npmjs.org/leaflet/-/leaflet-$LEAFLET_VERSION.tgz" |
+    tar -xzf - --strip-components=2 package/dist/leaflet.js package/dist/leaflet.css package/dist/images ||
+    { echo "embed.sh: Leaflet $LEAFLET_VERSION could not be downloaded" >&2; exit 1; }
+fi
+
+# Output the bytes of a file as the initializer of a C array.
+bytes()
+{
+  od -An -v -tx1 "$1" | awk '{ for (i = 1; i <= NF; ++i) printf("%s0x%s,", (n++ % 16) ? " " : "\n  ", $i) } END { print "" }'
+}
+
+cat <<'END'
+/* assets.h - Assets embedded in DUMPROWS
+ *
+ * Generated by assets/embed.sh.  Do not edit; add or replace files in the assets directory and regenerate instead.
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _ASSETS_H_
+#define _ASSETS_H_
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+struct asset
+{
+  const char * name, * type;
+  unsigned long version;
+  const unsigned char * data, * gzip_data;
+  size_t size, gzip_size;
+};
+
+
+/*************
+ * Constants *
+ *************/
+END
+
+LIST=$(find . -type f ! -name embed.sh | sed 's|^\./||' | LC_ALL=C sort)
+for f in $LIST
+do
+  ID=$(echo "$f" | tr 'a-z' 'A-Z' | tr -c 'A-Z0-9\n' '_')
+  CRC=$(cksum < "$f" | awk '{ printf("%08x", $1) }')
+  echo
+  echo "#define ASSET_URL_$ID \"?asset=$f&v=$CRC\""
+  echo "static const unsigned char ASSET_$ID[] ="
+  printf '{'; bytes "$f"; echo '};'
+  case "$f" in
+    *.js|*.css)
+      gzip -9n < "$f" > "$TMP"
+      if [ $(wc -c < "$TMP") -lt $(wc -c < "$f") ]
+      then
+        echo "static const unsigned char ASSET_${ID}_GZ[] ="
+        printf '{'; bytes "$TMP"; echo '};'
+      fi
+  esac
+done
+
+echo
+echo 'static const struct asset ASSETS[] ='
+echo '{'
+for f in $LIST
+do
+  ID=$(echo "$f" | tr 'a-z' 'A-Z' | tr -c 'A-Z0-9\n' '_')
+  CRC=$(cksum < "$f" | awk '{ printf("%08x", $1) }')
+  case "$f" in
+    *.js) TYPE="text/javascript" ;;
+    *.css) TYPE="text/css" ;;
+    *.png) TYPE="image/png" ;;
+    *.svg) TYPE="image/svg+xml" ;;
+    *) TYPE="application/octet-stream" ;;
+  esac
+  GZ="NULL, sizeof(ASSET_$ID), 0"
+  case "$f" in
+    *.js|*.css)
+      gzip -9n < "$f" > "$TMP"
+      [ $(wc -c < "$TMP") -lt $(wc -c < "$f") ] && GZ="ASSET_${ID}_GZ, sizeof(ASSET_$ID), sizeof(ASSET_${ID}_GZ)"
+  esac
+  echo "  { \"$f\", \"$TYPE\", 0x${CRC}UL, ASSET_$ID, $GZ },"
+done
+echo '};'
+
+cat <<'END'
+
+#define ASSET_COUNT (sizeof(ASSETS) / sizeof(ASSETS[0]))
+
+
+#endif  /* (prevent multiple inclusion) */
+END
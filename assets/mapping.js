@@ -0,0 +1,65 @@
+/* mapping.js - Map the geometry in a DUMPROWS results table (using Leaflet)
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Create a map above the results, for the (GeoJSON) geometry in the given column of the rows.  Features are added (by
+ * addFeatures) as rows arrive.  The properties of each feature (i.e., the other values in its row) are shown in a popup
+ * when the feature is clicked.
+ */
+function initMapping(e, c, r, g)
+{ var d = document.createElement('div'), m, l;
+  d.style.height = '60vh';
+  d.style.marginBottom = '8px';
+  e.parentNode.insertBefore(d, e);
+
+  /* If Leaflet is served by DUMPROWS, so are its images (which Leaflet would otherwise look for relative to its stylesheet). */
+  if (document.querySelector('link[href^="?asset=leaflet.css"]')) L.Icon.Default.imagePath = '?asset=images/';
+
+  /* Features are drawn on a canvas, which (unlike SVG) remains fast with a great many of them. */
+  m = L.map(d, { preferCanvas: true });
+  L.tileLayer('https://{s}.tile.openstreetmap.org/{z}/{x}/{y}.png',
+    { maxZoom: 19, attribution: '&copy; <a href="https://www.openstreetmap.org/copyright">OpenStreetMap</a> contributors' }).addTo(m);
+  l = L.geoJSON(null, { onEachFeature: function (f, l) { l.bindPopup(function () { return createPopup(c, r[f.properties], g); }); } });
+  l.addTo(m);
+  m.fitWorld();
+
+  return { map: m, layer: l, rows: r, geometry: g, count: 0, fitted: 0 };
+}
+
+/* Add a feature for each row that has arrived since the last call (up to a batch at a time, so that the page remains
+ * responsive).  The map is fitted to the features after the first batch, and again once all rows have been added.
+ * Return Value:  true if rows remain to be added; otherwise, false.
+ */
+function addFeatures(p, done)
+{ var r = p.rows, n = Math.min(r.length, p.count + 5000), a = [], f, q, i;
+  for (i = p.count; i < n; ++i)
+  { try { q = JSON.parse(r[i][p.geometry]); } catch { continue; }
+    if (q && Array.isArray(q.coordinates)) a.push({ type: 'Feature', geometry: q, properties: i });
+  }
+  p.layer.addData(a);
+  p.count = n;
+
+  f = (done && n == r.length) ? 2 : 1;
+  if (p.fitted < f && p.layer.getLayers().length) { p.map.fitBounds(p.layer.getBounds()); p.fitted = f; }
+  return n < r.length;
+}
+
+/* Create the content of a popup (a table of the column names and values in a row, other than the geometry). */
+function createPopup(c, v, g)
+{ var p = document.createElement('table'), n = c.length, j, r;
+  for (j = 0; j < n; ++j)
+  { if (j == g) continue;
+    r = p.insertRow();
+    r.insertCell().textContent = c[j];
+    r.insertCell().textContent = v[j];
+  }
+  return p;
+}
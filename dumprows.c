@@ -24,19 +24,47 @@
 #define _GNU_SOURCE
 #endif
 
-#include <sys/stat.h>   /* stat, (struct) stat */
-#include <ctype.h>      /* isdigit, isupper */
+#include <sys/stat.h>   /* stat, (struct) stat, S_IRWXG, S_IRWXO, umask */
+#ifdef _WIN32
+#  include <sys/timeb.h> /* _ftime, (struct) _timeb */
+#else
+#  include <sys/time.h>  /* gettimeofday, (struct) timeval */
+#endif
+#include <ctype.h>      /* isdigit, isupper, isxdigit */
 #include <errno.h>      /* EINVAL, errno */
+#ifdef _WIN32
+#  include <fcntl.h>    /* _O_BINARY */
+#  include <io.h>       /* _setmode */
+#endif
 #include <limits.h>     /* INT_MIN */
-#include <stdio.h>      /* EOF, fclose, ferror, fflush, fgetc, fgets, FILE, fopen,
-                           fputs, pclose/_pclose, popen/_popen, printf, puts */
-#include <stdlib.h>     /* EXIT_FAILURE, EXIT_SUCCESS, free, getenv, malloc */
-#include <string.h>     /* memcpy, strcasestr, strcmp, strerror, strlen, strncmp, _strnicmp, strstr */
+#include <stdio.h>      /* EOF, fclose, ferror, fgetc, fgets, FILE, fopen, fprintf, fread, fseek, printf, SEEK_SET, sprintf,
+                           stderr, stdin, stdout, ungetc */
+#include <stdlib.h>     /* EXIT_FAILURE, EXIT_SUCCESS, free, getenv, malloc, realloc, strtol, strtoul */
+#include <string.h>     /* memcmp, memcpy, memmove, memset, strcasestr, strchr, strcmp, strerror, strlen, strncmp, _strnicmp,
+                           strpbrk, strstr */
 #ifndef _WIN32
 #  include <strings.h>  /* strncasecmp */
+#  include <sys/wait.h> /* wait, WEXITSTATUS, WIFEXITED */
+#  include <unistd.h>   /* fork, pid_t, _exit */
 #endif
-#include "html.h"       /* HTML_PROMPT_1, HTML_PROMPT_2, HTML_PROMPT_3, HTML_RESULTS */
-#include "jb.h"         /* jb_command_error, jb_command_parse, jb_trim */
+#include <time.h>       /* gmtime, strftime, time_t */
+#include "assets.h"     /* (struct) asset, ASSET_COUNT, ASSETS */
+#include "html.h"       /* HTML_PROFILE, HTML_PROMPT_1, HTML_PROMPT_2, HTML_PROMPT_3, HTML_PROMPT_TEMPLATES_FORMAT,
+                           HTML_RESULTS_1, HTML_RESULTS_2 */
+#include "jb.h"         /* jb_command_error, (struct) jb_command_option, jb_command_parse, jb_file_read, jb_trim */
+#include "job.h"        /* (struct) job, job_create, job_open, job_path, job_read, job_release, job_spawn, job_state,
+                           job_status, job_wait, JOB_FORM, JOB_OUTPUT */
+#include "output.h"     /* output_char, output_close, output_count, output_csv_value, output_flush, output_format, output_html,
+                           output_json, output_line, output_open, output_string, output_write */
+#include "replica.h"    /* (struct) replica_set, replica_acquire, replica_close, replica_open, replica_release, REPLICA_HEALTHY,
+                           REPLICA_LEAST, REPLICA_MAX, REPLICA_ROUND_ROBIN, REPLICA_UNHEALTHY, REPLICA_UNKNOWN */
+#include "shard.h"      /* (struct) shard_plan, (struct) shard_scan, (struct) shard_set, shard_close, shard_open, shard_plan,
+                           shard_read, shard_reservoir, shard_sample, shard_scan, SHARD_BINARY, SHARD_MAX, SHARD_NULLS_FIRST,
+                           SHARD_SAMPLE_BERNOULLI, SHARD_SAMPLE_MAX, SHARD_SAMPLE_ROWID, SHARD_WORKERS */
+#include "snapshot.h"   /* (struct) snapshot, snapshot_age, snapshot_begin, snapshot_end, snapshot_keep, snapshot_lock,
+                           snapshot_open, snapshot_path, snapshot_read, snapshot_spawn, snapshot_unlock, SNAPSHOT_ID_LENGTH,
+                           SNAPSHOT_OUTPUT */
+#include "source.h"     /* SOURCE_FLUSH, SOURCE_MESSAGE_MAX_LENGTH, SOURCE_SQLPLUS */
 
 
 /*************
@@ -47,25 +75,109 @@ static const char * STR_USAGE = " FILE";
 static const char * STR_HELP =
   "DUMPROWS (Database Utility Map-Producing Read-Only Web Service).\n"
   "This application is meant to be run as a Common Gateway Interface (CGI) program.\n"
-  "To test via command line, set the QUERY_STRING environment variable.\n"
+  "To test via command line, set the QUERY_STRING environment variable (or set REQUEST_METHOD\n"
+  "to POST, set CONTENT_TYPE and CONTENT_LENGTH, and supply the request body on standard input).\n"
   "For more information, see the home page.\n"
   "Options:\n"
-  "  -h, --help  output this message and exit";
+  "  -h, --help         output this message and exit\n"
+  "  -j, --job=ID       execute a job (as a worker, which an export request spawns)\n"
+  "  -s, --snapshot=ID  refresh a snapshot (in the background, which a request for a stale snapshot spawns)\n"
+  "  -w, --warm=FILE    warm the caches by executing the queries listed in a manifest file (see the home page)";
 static const char * STR_QUERY = "query string is not valid";
+static const char * STR_BODY = "request body is not valid";
+static const char * STR_CONTENT = "Unsupported content type";
 static const char * STR_RESULTS = "Results";
 static const char * STR_FILE = "File is improperly formatted";
+static const char * STR_TEMPLATE = "Template not found";
+static const char * STR_TEMPLATE_FILE = "Template file is not valid";
+static const char * STR_PARAM = "Template parameter is missing or not valid";
+static const char * STR_ASSET = "Asset not found";
 static const char * STR_DATABASE = "Unknown database engine/utility";
 static const char * STR_PROMPT = "Prompt";
 static const char * STR_READING = "Error reading template file";
+static const char * STR_BUILD = __DATE__ " " __TIME__;
 static const char * STR_TEMPLATES = "Not all templates loaded successfully.";
 static const char * STR_ERROR = "Error";
+static const char * STR_BATCH = "Batch must comprise from one to sixteen queries";
+static const char * STR_FORMAT = "Export format must be csv or ndjson";
+static const char * STR_JOB = "Job not found";
+static const char * STR_JOB_PENDING = "Job is not done";
+static const char * STR_SAMPLE = "Sample size must be a number from 1 to 10000";
+static const char * STR_RANGES = "Too many ranges";
+static const char * STR_COMBINATIONS = "Ranges must stand for at most 65536 queries";
+static const char * STR_PROFILE = "Profile";
+static const char * STR_PLAN = "Plan";
+static const char * STR_PLAN_ANALYZE = "Plan (second execution, by EXPLAIN ANALYZE)";
+static const char * STR_EXPLAIN = "Query plans are available only for PostgreSQL and SQLite";
+static const char * STR_TIMING_FORMAT = "<tr><th>%s</th><td class='n'>%.1f</td></tr>";
+static const char * STR_WARM_FORMAT = "%s, line %d: %s\n";
+static const char * STR_WARMED_FORMAT = "%d queries executed, %d errors\n";
+#ifdef _WIN32
+static const char * STR_NULL_DEVICE = "NUL";
+#else
+static const char * STR_NULL_DEVICE = "/dev/null";
+#endif
 
-/* Command lines */
-static const char * STR_SQLPLUS = "sqlplus -M \"HTML ON HEAD '<title>Results - DUMPROWS</title>"
-  HTML_RESULTS "' BODY 'onload=''init()''' TABLE ''\" -S -F ";
-static const char * STR_PSQL = "psql -H ";
-static const char * STR_SQLITE = "sqlite3 -header -html -batch ";
-static const char * STR_SPATIALITE = "spatialite -header -html -silent -batch ";
+/* Export formats, and the states of a job */
+static const char * STR_CSV = "csv";
+static const char * STR_NDJSON = "ndjson";
+static const char * STR_RUNNING = "running";
+static const char * STR_DONE = "done";
+static const char * STR_FAILED = "failed";
+
+/* Optional directives that can follow the template path in the script file */
+static const char * STR_SHARD = "Shard:";
+static const char * STR_WORKERS = "Workers:";
+static const char * STR_REPLICA = "Replica:";
+static const char * STR_BALANCE = "Balance:";
+static const char * STR_LEAST = "least";
+static const char * STR_ROUND_ROBIN = "round-robin";
+
+/* Characters that can appear in a template parameter value substituted outside of a string literal (i.e., an identifier) */
+static const char * STR_IDENTIFIER = "$.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+
+/* SQL*Plus commands that precede every query (so that only records are output, and an error ends the session) */
+static const char * STR_SQLPLUS_COMMANDS = "SET FEEDBACK OFF\nSET PAGESIZE 50000\nWHENEVER SQLERROR EXIT FAILURE\n";
+
+/* SQL*Plus commands used to declare and assign bind variables (substituted for template parameters) */
+static const char * STR_BIND_FORMAT = "VARIABLE b%d VARCHAR2(4000)\nEXECUTE :b%d := '";
+
+/* HTTP response header fields */
+static const char * STR_HTML_HEADER = "Content-Type: text/html\r\n";
+static const char * STR_JSON_HEADER = "Content-Type: application/json\r\n";
+static const char * STR_ROWS_HEADER = "Content-Type: application/x-ndjson\r\n";
+static const char * STR_CSV_HEADER = "Content-Type: text/csv\r\n";
+static const char * STR_ACCEPTED = "Status: 202 Accepted\r\n";
+static const char * STR_BAD_REQUEST = "Status: 400 Bad Request\r\n";
+static const char * STR_NOT_FOUND = "Status: 404 Not Found\r\n";
+static const char * STR_CONFLICT = "Status: 409 Conflict\r\n";
+static const char * STR_UNAVAILABLE = "Status: 503 Service Unavailable\r\n";
+static const char * STR_PARTIAL = "Status: 206 Partial Content\r\n";
+static const char * STR_UNSATISFIABLE_FORMAT = "Status: 416 Range Not Satisfiable\r\nContent-Range: bytes */%ld\r\n";
+static const char * STR_DOWNLOAD_FORMAT = "%sContent-Length: %ld\r\nAccept-Ranges: bytes\r\n"
+                                          "Content-Disposition: attachment; filename=\"dumprows-%s.%s\"\r\n";
+static const char * STR_RANGE_FORMAT = "Content-Range: bytes %ld-%ld/%ld\r\n";
+static const char * STR_AGE_FORMAT = "%sAge: %ld\r\n";
+static const char * STR_NOT_MODIFIED = "Status: 304 Not Modified\r\n";
+static const char * STR_VALIDATORS_FORMAT = "ETag: %s\r\nCache-Control: %s\r\n";
+static const char * STR_MODIFIED_FORMAT = "Last-Modified: %s\r\n";
+static const char * STR_ASSET_FORMAT = "Content-Type: %s\r\nContent-Length: %lu\r\n%sVary: Accept-Encoding\r\n";
+static const char * STR_GZIP = "Content-Encoding: gzip\r\n";
+static const char * STR_REVALIDATE = "no-cache";
+static const char * STR_IMMUTABLE = "public, max-age=31536000, immutable";
+
+/* Statements that precede a query to obtain its plan:  PostgreSQL executes the query a second time, and reports the time and
+ * buffers used by each step, whereas SQLite only reports the steps (as SQL*Plus would, were it not to write a plan table to
+ * do so).
+ */
+static const char * STR_PSQL_EXPLAIN = "EXPLAIN (ANALYZE, BUFFERS) ";
+static const char * STR_SQLITE_EXPLAIN = "EXPLAIN QUERY PLAN ";
+
+/* Command lines (each of which causes the database utility to output CSV, with column headings) */
+static const char * STR_SQLPLUS = "sqlplus -M \"CSV ON\" -S -F ";
+static const char * STR_PSQL = "psql --csv -q -v ON_ERROR_STOP=1 ";
+static const char * STR_SQLITE = "sqlite3 -csv -header -batch -readonly ";
+static const char * STR_SPATIALITE = "spatialite -csv -header -silent -batch ";
 
 
 /*********************
@@ -77,10 +189,75 @@ static const char * STR_SPATIALITE = "spatialite -header -html -silent -batch ";
 #define strncasecmp _strnicmp
 #endif
 
+#define BUFFER_SIZE 0x10000  /* 65536 */
+#define HEADER_MAX_LENGTH 0x200  /* 512 */
+#define BIND_VALUE_MAX 0x7D0  /* 2000 */
+#define TEMPLATE_PARAM_MAX 0x20  /* 32 */
+#define BATCH_MAX 0x10  /* 16 */
+#define WARM_MAX 0x10000  /* 65536 */
+
+/* Formats in which output_rows outputs rows */
+#define FORMAT_STREAM 0  /* newline-delimited JSON, preceded by the header and followed by the row count (or error message) */
+#define FORMAT_NDJSON 1  /* newline-delimited JSON only (for an export job) */
+#define FORMAT_CSV 2  /* CSV (for an export job) */
+
+/* These are used to scan a word (eight bytes) at a time for the characters of interest when URL-decoding. */
+#define WORD_ONES 0x0101010101010101ULL
+#define WORD_HIGHS 0x8080808080808080ULL
+#define word_has(w, c) ((((w) ^ (WORD_ONES * (c))) - WORD_ONES) & ~((w) ^ (WORD_ONES * (c))) & WORD_HIGHS)
+
 #define char_to_hex(c) (c - (isdigit(c) ? '0' : ((isupper(c) ? 'A' : 'a') - 0xA)))
-#define output_begin(title) printf("<html lang='en-US'><head><meta charset='UTF-8' /><title>%s - DUMPROWS</title>", title)
-#define output_bridge(attribution) printf("</head><body%s>", attribution)
-#define output_end() puts("</body></html>")
+#define json_hex(p) ((isxdigit((p)[0]) && isxdigit((p)[1]) && isxdigit((p)[2]) && isxdigit((p)[3])) ? \
+  ((char_to_hex((p)[0]) << 12) | (char_to_hex((p)[1]) << 8) | (char_to_hex((p)[2]) << 4) | char_to_hex((p)[3])) : -1)
+/* FNV-1a is used to hash file versions into entity tags. */
+#define HASH_BASIS 0x811C9DC5UL
+#define HASH_PRIME 0x01000193UL
+
+/* The jobs of a script file are kept together, in a directory named for the hash of its path. */
+#define script_key(path) hash_bytes(HASH_BASIS, path, strlen(path))
+
+#define output_begin(title) \
+  output_format("<html lang='en-US'><head><meta charset='UTF-8' /><title>%s - DUMPROWS</title>", title)
+#define output_bridge(attribution) output_format("</head><body%s>", attribution)
+#define output_end() output_line("</body></html>")
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* A query template, as read from a query template (JSON) file.  Its format contains a placeholder
+ * (the parameter name enclosed in braces) wherever the value of each parameter is to be substituted.
+ * If its results are kept as a snapshot, it also has the number of seconds for which a snapshot is fresh.
+ */
+struct template
+{
+  char * title, * format, * params[TEMPLATE_PARAM_MAX];
+  int param_count;
+  long snapshot;
+};
+
+/* The contents of the script file:  the command line for each shard (the first of which is on the connection line, and any
+ * others on Shard lines), the template path, and the maximum number of shards to query at once (from the Workers line, or
+ * zero if there is none).  If there are Replica lines instead, the command lines are for replicas, one of which is chosen
+ * by the balance policy.
+ */
+struct script
+{
+  char * buffer, * template_path;
+  const char * commands[SHARD_MAX];
+  int command_count, workers, replicated, balance;
+};
+
+
+/* The times (from wall_time) at which the phases of executing a query begin and end, as recorded by output_rows for a
+ * profile:  the query is prepared (expanded and verified), then started (until the database utility outputs the first
+ * record, i.e., the column headings), then its rows are fetched.
+ */
+struct profile
+{
+  double start, prepared, started, fetched;
+};
 
 
 /*********************************
@@ -92,11 +269,47 @@ static const char * STR_SPATIALITE = "spatialite -header -html -silent -batch ";
 char * strcasestr(const char * haystack, const char * needle);
 #endif
 
-const char * read_file(char * argv[], size_t length, FILE ** stream_ptr, char ** string_ptr);
+const char * read_body(char ** string_ptr, size_t * length_ptr, int * form_ptr);
+char * url_decode(char * dest, char ** src_ptr, const char * end, int final);
+char * find_param(char * string, size_t length, const char * name);
+const char * read_file(char * argv[], FILE ** stream_ptr, struct script * script_ptr);
 const char * read_line(char * string, int count, FILE * stream);
-void output_prompt(const char * path);
-const char * read_templates(const char * path, char ** string_ptr);
+int header_required(void);
+void output_header(const char * fields);
+int output_validators(const char * fields, unsigned long hash, time_t time, const char * cache);
+unsigned long hash_file(const char * path, unsigned long hash, time_t * time_ptr);
+unsigned long hash_bytes(unsigned long hash, const void * buffer, size_t size);
+void output_prompt(char * argv[], const char * path);
+const char * output_templates(const char * path, const char * version);
+const char * output_asset(const char * name, const char * version);
+void output_results(char * string, size_t length, int form);
+const char * output_rows(struct script * script_ptr, char * form, size_t length, int format, long * count_ptr,
+                         struct profile * profile_ptr);
+const char * output_snapshot(char * argv[], struct script * script_ptr, char * form, size_t length);
+const char * make_snapshot(struct script * script_ptr, char * form, size_t length, struct snapshot * snapshot_ptr);
+const char * output_profile(struct script * script_ptr, char * form, size_t length);
+const char * output_batch(struct script * script_ptr, char * form, size_t length);
+const char * output_export(char * argv[], char * form, size_t length);
+const char * output_job(char * argv[], const char * id, int download);
+int parse_range(const char * range, long size, long * first_ptr, long * last_ptr);
+int execute_job(char * argv[], const char * id);
+int execute_snapshot(char * argv[], const char * id);
+int warm_caches(char * argv[], const char * path);
+const char * warm_query(struct script * script_ptr, char * form, size_t length, unsigned long key);
+int warm_range(const char * value, long * first_ptr, long * last_ptr);
+void output_record(char ** fields, int count, int line);
+void output_csv(char ** fields, int count);
+const char * expand_template(const char * path, const char * title, char * string, size_t length,
+                             int bind, char ** buffer_ptr, char ** query_ptr, long * snapshot_ptr);
+long find_snapshot(struct script * script_ptr, char * form, size_t length, char * id, char ** query_ptr);
+int match_snapshot(struct script * script_ptr, char * form, size_t length, struct snapshot * snapshot_ptr);
+const char * find_template(char * json, const char * title, struct template * template_ptr);
+char * json_skip(char * p);
+char * json_string(char ** p_ptr);
+int json_value(char ** p_ptr);
+char * append_value(char * dest, const char * value, int literal);
 size_t validate_query(const char * string);
+double wall_time(void);
 int finalize(char * string, char * query, const char * error);
 
 
@@ -110,109 +323,75 @@ int finalize(char * string, char * query, const char * error);
  */
 int main(int argc, char * argv[])
 {
-  int n, i;
-  char * s, * r, * q, * q1, * s1;
+  int n, k;
+  size_t m;
+  char * s, * r, * q, * b = NULL;
+  struct script t;
+  struct jb_command_option o[3] = { { { "job=", "j" }, { 0 } }, { { "snapshot=", "s" }, { 0 } }, { { "warm=", "w" }, { 0 } } };
   FILE * f;
   const char * p;
 
   /* Verify usage. */
-  n = jb_command_parse(argc, argv, STR_USAGE, STR_HELP, NULL, 0, 1);
+  n = jb_command_parse(argc, argv, STR_USAGE, STR_HELP, o, 3, 1);
   if (n < 0) return (n == INT_MIN) ? EXIT_SUCCESS : EXIT_FAILURE;
+#ifndef _WIN32
+  /* Files that this program creates (e.g., of jobs and snapshots, which hold results) are accessible only to this user. */
+  umask(S_IRWXG | S_IRWXO);
+#endif
 
-  /* Retrieve the CGI environment variable QUERY_STRING, which (if nonempty) should contain an SQL SELECT statement. */
-  if (!(s = getenv("QUERY_STRING"))) { jb_command_error(argv[0], STR_USAGE); return EXIT_FAILURE; }
-
-  /* Retrieve the CGI environment variable SERVER_SOFTWARE, which is used to determine
-   * whether or not to output the entity-header (required by all web servers except IIS).
+  /* A worker (spawned to execute a job) is given the job ID as an option, which precedes the script file, as is a process
+   * spawned to refresh a snapshot (given the snapshot ID).  Caches are warmed from the command line (given a manifest).
    */
-  if (!(r = getenv("SERVER_SOFTWARE")) || !strlen(r) || strncmp(r, "Microsoft-IIS", 13))
-    printf("Content-Type: text/html\r\n\r\n");
+  argv[1] = argv[argc - 1];
+  if (o[0].argument) return execute_job(argv, o[0].argument);
+  if (o[1].argument) return execute_snapshot(argv, o[1].argument);
+  if (o[2].argument) return warm_caches(argv, o[2].argument);
 
-  puts("<!DOCTYPE html>");
-
-  /* Read and parse the script file. */
-  p = read_file(argv, n = strlen(s), &f, &r);
-  if (f) fclose(f);
-  if (p) return finalize(r, NULL, p);
-
-  /* If the query string is empty, output a web page to prompt for a query. */
-  if (!n) { output_prompt(r); return finalize(r, NULL, NULL); }
-
-  /* The query string must begin with "q=". */
-  if (strncmp(s, "q=", 2)) return finalize(r, NULL, STR_QUERY);
-
-  /* Replace plus signs in the query string with spaces. */
-  for (q = s; *q; ++q) if (*q == '+') *q = ' ';
+  /* Retrieve the CGI environment variable QUERY_STRING, which (if nonempty) should contain an SQL SELECT statement. */
+  if (!(s = getenv("QUERY_STRING"))) { jb_command_error(argv[0], STR_USAGE); return EXIT_FAILURE; }
 
-  /* Allocate memory for the query (i.e., the SQL SELECT statement to be parsed from the query string).
-   * (Conveniently, the "q=" provides two extra bytes needed for an optional semicolon and a terminating null byte.)
+  /* If the request method is POST, the query is in the request body (which is read and decoded in place).
+   * Otherwise, the query is in the query string, which is URL-decoded in place (no copy is needed).
    */
-  if (!(q = malloc(strlen(s)))) return finalize(r, NULL, strerror(errno));
-
-  /* URL-decode the query. */
-  for (q1 = q, s1 = s + 2; p = strchr(s1, '%'); q1 += n + 1, s1 += n + 3)
+  if ((r = getenv("REQUEST_METHOD")) && !strcmp(r, "POST"))
   {
-    if (!p[1]) break; i = 0x10 * char_to_hex(p[1]);
-    if (!p[2]) break; i += char_to_hex(p[2]);
-    memcpy(q1, s1, n = p - s1); q1[n] = i;
+    if (p = read_body(&b, &m, &k)) return finalize(NULL, b, p);
+    s = b;
   }
-  memcpy(q1, s1, strlen(s1) + 1);
-
-  /* Verify that the query is a valid SQL SELECT statement. */
-  if (!(n = validate_query(q1 = jb_trim(q)))) return finalize(r, q, STR_QUERY);
-  if (q1[n - 1] != ';') { q1[n] = ';'; q1[++n] = '\0'; }
-
-  /* Execute the command line (which should invoke a database utility), creating a pipe between this
-   * process and the child process.  The writable end of the pipe is associated with the resulting
-   * stream, and the readable end is associated with the spawned command's standard input.
-   */
-#ifdef _WIN32
-  f = _popen(r, "w");
-#else
-  f = popen(r, "w");
-#endif
-  if (!f) return finalize(r, q, strerror(errno));
+  else { q = s; m = url_decode(s, &q, s + strlen(s), 1) - s; s[m] = '\0'; k = 1; }
 
-  /* SQL*Plus is the only database utility that outputs the entire <html> element,
-   * so if the database utility is not SQL*Plus, output the beginning of the HTML.
-   */
-  if (n = strncmp(r, STR_SQLPLUS, strlen(STR_SQLPLUS)))
+  /* If an asset (e.g., a script used by the results page) is requested, output it.  (The script file is not needed.) */
+  if (k && (q = find_param(s, m, "asset")))
   {
-    /* The single-quoted strings in this macro are escaped (necessarily) for SQL*Plus, so unescape them here. */
-    if (!(s = malloc(strlen(p = HTML_RESULTS)))) return finalize(r, q, strerror(errno));
-    for (s1 = s; *p; ++s1) { *s1 = *p; if (*++p == '\'' && *s1 == '\'') ++p; } *s1 = '\0';
+    p = output_asset(q, find_param(s, m, "v")); finalize(NULL, b, NULL);
+    return p ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
 
-    /* Output the beginning of the HTML, and free memory allocated memory for the unescaped string. */
-    output_begin(STR_RESULTS); fputs(s, stdout); output_bridge(" onload='init()'"); free(s);
+  /* Read and parse the script file. */
+  p = read_file(argv, &f, &t);
+  if (f) fclose(f);
+  if (p) return finalize(t.buffer, b, p);
 
-    /* psql outputs the <table> tags, whereas the others (SQLite and SpatiaLite)
-     * don't, so if the database utility is not psql, output the <table> start-tag.
-     */
-    if (i = strncmp(r, STR_PSQL, strlen(STR_PSQL))) puts("<table>");
-  }
+  /* If the query string (or request body) is empty, output a web page to prompt for a query. */
+  if (!m) { output_prompt(argv, t.template_path); return finalize(t.buffer, b, NULL); }
 
-  /* Standard output is usually buffered, so ensure that the HTML
-   * of this process is output before that of the child process.
-   */
-  fflush(stdout);
+  /* If templates are requested (by the prompt), output the contents of the query template file. */
+  if (k && (q = find_param(s, m, "templates"))) { p = output_templates(t.template_path, q); return finalize(t.buffer, b, p); }
 
-  /* Write the query to the spawned command's standard input via the stream (the writable end
-   * of the pipe).  Note that the spawned command does not output until the stream is closed.
+  /* Unless rows are requested (by the results page), a batch of queries is requested, or an export job is requested (or
+   * asked about), output the results page, which requests the rows (with the same form data).  Otherwise, execute the query
+   * (or queries), and output the rows; or create a job to execute the query, or output its status or results.  A profile
+   * (requested instead of the results page) executes the query, and outputs its plan and timings.
    */
-  fputs(q1, f);
-#ifdef _WIN32
-  _pclose(f);
-#else
-  pclose(f);
-#endif
-
-  /* Output the <table> end-tag and the ending of the HTML as needed (see above), and we're done. */
-  if (n)
-  {
-    if (i) puts("</table>");
-    output_end();
-  }
-  return finalize(r, q, NULL);
+  if (!k || !(q = find_param(s, m, "f"))) q = "";
+  if (!strcmp(q, "rows")) p = output_snapshot(argv, &t, s, m);
+  else if (!strcmp(q, "batch")) p = output_batch(&t, s, m);
+  else if (!strcmp(q, "export")) p = output_export(argv, s, m);
+  else if (!strcmp(q, "status") || !strcmp(q, "download")) p = output_job(argv, find_param(s, m, "job"), *q == 'd');
+  else if (k && (r = find_param(s, m, "profile")) && *r && strcmp(r, "0")) p = output_profile(&t, s, m);
+  else { output_results(s, m, k); return finalize(t.buffer, b, NULL); }
+  finalize(t.buffer, b, NULL);
+  return p ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 #ifdef _WIN32
@@ -235,24 +414,128 @@ char * strcasestr(const char * haystack, const char * needle)
 
 #endif
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the body of a POST request from standard input, a chunk at a time.  Form data is URL-decoded in place as each chunk
+ * arrives, so that the body is never copied.
+ *   string_ptr:  receives request body (memory for this buffer is obtained with malloc, and should be freed with free)
+ *   length_ptr:  receives length of request body (after decoding)
+ *   form_ptr:  receives nonzero if the body is form data (application/x-www-form-urlencoded), or zero if it is plain text
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * read_body(char ** string_ptr, size_t * length_ptr, int * form_ptr)
+{
+  size_t n, k;
+  char * s, * p, * d, * e;
+
+  /* Ensure that string_ptr can be safely passed to free. */
+  *string_ptr = NULL;
+
+  /* The content type determines whether or not the body needs to be decoded. */
+  if (!(p = getenv("CONTENT_TYPE"))) return STR_CONTENT;
+  if (!strncasecmp(p, "application/x-www-form-urlencoded", 33)) *form_ptr = 1;
+  else if (!strncasecmp(p, "text/plain", 10)) *form_ptr = 0;
+  else return STR_CONTENT;
+
+  /* The content length determines how much to read (and thus how much memory to allocate). */
+  if (!(p = getenv("CONTENT_LENGTH"))) return STR_BODY;
+  n = strtoul(p, &e, 10);
+  if (*e) return STR_BODY;
+  if (!(*string_ptr = s = malloc(n + 1))) return strerror(errno);
+
+  /* Read the body a chunk at a time.  Decoded data never overtakes the data yet to be decoded, so each chunk can be
+   * decoded in place (with any incomplete percent-encoded octet at the end of the chunk held over for the next one).
+   */
+  for (d = p = e = s; n; n -= k)
+  {
+    if (!(k = fread(e, 1, (n < BUFFER_SIZE) ? n : BUFFER_SIZE, stdin))) return ferror(stdin) ? strerror(errno) : STR_BODY;
+    e += k;
+    if (*form_ptr) d = url_decode(d, &p, e, n == k);
+  }
+  if (!*form_ptr) d = e;
+
+  *d = '\0'; *length_ptr = d - s; return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * URL-decode form data (e.g., a query string).  Plus signs are replaced with spaces, percent-encoded octets are replaced with
+ * the bytes they represent, and each ampersand (separating name/value pairs) is replaced with a null byte.  Input is scanned a
+ * word at a time, and runs without any of these characters are moved in bulk, so the common case costs little.
+ *   dest:  buffer to receive decoded data (may be the same as, or precede, the data to decode)
+ *   src_ptr:  pointer to data to decode (on return, points to the first byte that was not decoded)
+ *   end:  end of data to decode
+ *   final:  if zero, an incomplete percent-encoded octet at the end is left for the next call to decode
+ * Return Value:  Pointer to the end of the decoded data.
+ */
+char * url_decode(char * dest, char ** src_ptr, const char * end, int final)
+{
+  unsigned long long w;
+  char * p = *src_ptr, * q;
+  size_t n;
+
+  while (p < end)
+  {
+    /* Find the next character of interest, skipping whole words that contain none. */
+    for (q = p; q + 8 <= end; q += 8)
+    {
+      memcpy(&w, q, 8);
+      if (word_has(w, '%') | word_has(w, '+') | word_has(w, '&')) break;
+    }
+    while (q < end && *q != '%' && *q != '+' && *q != '&') ++q;
+
+    /* Move the run of ordinary characters preceding it. */
+    if (n = q - p) { if (dest != p) memmove(dest, p, n); dest += n; }
+    if ((p = q) == end) break;
+
+    /* Decode the character of interest. */
+    if (*p == '+') { *dest++ = ' '; ++p; }
+    else if (*p == '&') { *dest++ = '\0'; ++p; }
+    else if (p + 2 < end)
+    {
+      if (isxdigit(p[1]) && isxdigit(p[2])) { *dest++ = 0x10 * char_to_hex(p[1]) + char_to_hex(p[2]); p += 3; }
+      else *dest++ = *p++;
+    }
+    else if (final) *dest++ = *p++;
+    else break;
+  }
+
+  *src_ptr = p; return dest;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Find the value of a parameter in decoded form data.
+ *   string:  decoded form data (name/value pairs, each terminated by a null byte)
+ *   length:  length of decoded form data
+ *   name:  parameter name
+ * Return Value:  Pointer to the (null-terminated) value (which is empty if the parameter
+ *   is present with no value), or NULL if the parameter is not present.
+ */
+char * find_param(char * string, size_t length, const char * name)
+{
+  char * p, * e = string + length;
+  size_t n = strlen(name);
+
+  for (p = string; p < e; p += strlen(p) + 1)
+    if (!strncmp(p, name, n) && (p[n] == '=' || !p[n])) return p + n + !!p[n];
+  return NULL;
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Read and parse the script file.
  *   argv:  array of command line arguments (same as argv passed to main)
- *   length:  length of query string (determines what string_ptr receives)
  *   stream_ptr:  receives pointer to script file (which, if non-null, should be closed with fclose)
- *   string_ptr:  if length is zero, receives template path; otherwise, receives command line
- *     (memory for this buffer is obtained with malloc, and should be freed with free)
+ *   script_ptr:  receives contents of script file (whose buffer, if non-null, should be freed with free)
  * Return Value:  NULL on success; otherwise, an error message.
  */
-const char * read_file(char * argv[], size_t length, FILE ** stream_ptr, char ** string_ptr)
+const char * read_file(char * argv[], FILE ** stream_ptr, struct script * script_ptr)
 {
   struct stat st;
-  int n, m, k;
-  char * s;
+  int n, m, c, k;
+  char * s, * r;
   const char * p, * q;
 
-  /* Ensure that string_ptr can be safely passed to free. */
-  *string_ptr = NULL;
+  /* Ensure that the buffer can be safely passed to free. */
+  memset(script_ptr, 0, sizeof(struct script));
+  script_ptr->balance = REPLICA_LEAST;
 
   /* Open the script file for reading. */
   if (!(*stream_ptr = fopen(argv[1], "r"))) return strerror(errno);
@@ -271,26 +554,56 @@ const char * read_file(char * argv[], size_t length, FILE ** stream_ptr, char **
   else if (!strcmp(s, "SQLite")) q = STR_SQLITE;
   else if (!strcmp(s, "SpatiaLite")) q = STR_SPATIALITE;
   else { free(s); return STR_DATABASE; }
+  free(s);
 
-  /* The next line should comprise the connection information.  If the query string is nonempty (i.e., we're going to run
-   * the query and output results), build the command line using the database utility and this connection information.
+  /* Allocate memory for the command lines and template path (the lines of the file
+   * cannot be longer than the file, and each command line begins with the utility).
    */
-  if (p = read_line(s, n, *stream_ptr)) { free(s); return p; }
-  if (length)
-  {
-    *string_ptr = malloc((m = strlen(q)) + (k = strlen(s) + 1));
-    memcpy(*string_ptr, q, m);
-    memcpy(*string_ptr + m, s, k);
-  }
+  if (!(script_ptr->buffer = s = malloc((m = strlen(q)) * SHARD_MAX + 2 * n))) return strerror(errno);
+
+  /* The next line should comprise the connection information, which
+   * follows the database utility to complete the command line.
+   */
+  memcpy(s, q, m);
+  if (p = read_line(s + m, n, *stream_ptr)) return p;
+  script_ptr->commands[script_ptr->command_count++] = s;
 
   /* The next line can be empty.  If nonempty, it should contain the relative path to a query template (JSON) file.
-   * This applies if the query string is empty (i.e., we're going to output a web page to prompt for a query).
+   * This is used to prompt for a query (and to expand a query template).
    */
-  if (p = read_line(s, n, *stream_ptr)) { free(s); return p; }
-  if (length) free(s); else *string_ptr = s;
+  if (p = read_line(script_ptr->template_path = s += strlen(s) + 1, n, *stream_ptr)) return p;
 
-  /* There should be nothing else in the file. */
-  return (fgetc(*stream_ptr) == EOF) ? (ferror(*stream_ptr) ? strerror(errno) : NULL) : STR_FILE;
+  /* Any remaining lines are directives.  Each Shard line comprises the connection information for another shard (e.g.,
+   * another database file), which is queried along with the first.  A Workers line limits how many are queried at once.
+   * (For a single SQLite database, it indicates how many rowid ranges a scan of a table is split into.)  Alternatively,
+   * each Replica line comprises the connection information for another replica (i.e., a copy of the first database),
+   * only one of which is queried.  A Balance line indicates how it is chosen.
+   */
+  for (s += strlen(s) + 1; (c = fgetc(*stream_ptr)) != EOF;)
+  {
+    ungetc(c, *stream_ptr);
+    if (p = read_line(s + m, n, *stream_ptr)) return p;
+    if ((k = !strncmp(s + m, STR_REPLICA, c = strlen(STR_REPLICA))) || !strncmp(s + m, STR_SHARD, c = strlen(STR_SHARD)))
+    {
+      if (script_ptr->command_count == (k ? REPLICA_MAX : SHARD_MAX)) return STR_FILE;
+      if (script_ptr->command_count > 1 && script_ptr->replicated != k) return STR_FILE;
+      r = jb_trim(s + m + c); memmove(s + m, r, strlen(r) + 1); memcpy(s, q, m);
+      script_ptr->commands[script_ptr->command_count++] = s; s += strlen(s) + 1;
+      script_ptr->replicated = k;
+    }
+    else if (!strncmp(s + m, STR_WORKERS, c = strlen(STR_WORKERS)))
+    {
+      if ((script_ptr->workers = strtoul(s + m + c, &r, 10)) <= 0 || *jb_trim(r)) return STR_FILE;
+    }
+    else if (!strncmp(s + m, STR_BALANCE, c = strlen(STR_BALANCE)))
+    {
+      if (!strcmp(r = jb_trim(s + m + c), STR_LEAST)) script_ptr->balance = REPLICA_LEAST;
+      else if (!strcmp(r, STR_ROUND_ROBIN)) script_ptr->balance = REPLICA_ROUND_ROBIN;
+      else return STR_FILE;
+    }
+    else return STR_FILE;
+  }
+  return ferror(*stream_ptr) ? strerror(errno) : NULL;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -312,62 +625,1287 @@ const char * read_line(char * string, int count, FILE * stream)
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Output an HTML document to prompt for a query.
- *   path:  pathname of query template (JSON) file
+ * Determine whether or not the CGI response header must be output (which it must be for all web servers except IIS).
+ * Return Value:  Nonzero if the header must be output; otherwise, zero.
+ */
+int header_required(void)
+{
+  const char * p = getenv("SERVER_SOFTWARE");
+  return !p || !strlen(p) || strncmp(p, "Microsoft-IIS", 13);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the CGI response header (as needed).
+ *   fields:  header fields (each terminated by CRLF)
+ */
+void output_header(const char * fields)
+{
+  if (header_required()) output_format("%s\r\n", fields);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the CGI response header for a response that can be cached, including its validators (entity tag and modification
+ * time).  If the request is conditional (i.e., the client already has a copy of the response) and the validators match,
+ * the response is 304 (Not Modified), and there is nothing more to output.
+ *   fields:  header fields (each terminated by CRLF), output only if the response is not 304
+ *   hash:  hash from which the entity tag is derived
+ *   time:  modification time (or zero if there is none)
+ *   cache:  value of the Cache-Control header field
+ * Return Value:  Nonzero if the response is 304 (Not Modified); otherwise, zero.
  */
-void output_prompt(const char * path)
+int output_validators(const char * fields, unsigned long hash, time_t time, const char * cache)
 {
-  char * s;
+  char s[HEADER_MAX_LENGTH], e[0x10], t[0x40];
   const char * p;
+  int n;
 
-  /* Begin HTML output. */
-  output_begin(STR_PROMPT); fputs(HTML_PROMPT_1, stdout);
+  /* If the header is not output, the response cannot be validated. */
+  if (!header_required()) return 0;
 
-  /* If a query template file was specified, read its contents (which should be JSON). */
-  if (strlen(path))
+  sprintf(e, "\"%08lx\"", hash);
+  n = sprintf(s, STR_VALIDATORS_FORMAT, e, cache);
+  if (time) { strftime(t, sizeof(t), "%a, %d %b %Y %H:%M:%S GMT", gmtime(&time)); sprintf(s + n, STR_MODIFIED_FORMAT, t); }
+
+  /* The entity tag takes precedence over the modification time.  (Browsers send
+   * back the modification time exactly as it was received, so it need not be parsed.)
+   */
+  if ((p = getenv("HTTP_IF_NONE_MATCH")) ? (strstr(p, e) || !strcmp(p, "*"))
+      : (time && (p = getenv("HTTP_IF_MODIFIED_SINCE")) && !strcmp(p, t)))
   {
-    if (p = read_templates(path, &s)) printf("showMessage('%s: %s', 'red'); ", STR_READING, p);
-    else printf("if (!processTemplates('%s')) showMessage('%s', 'orange'); ", s, STR_TEMPLATES);
-    free(s);
+    output_format("%s%s\r\n", STR_NOT_MODIFIED, s);
+    return 1;
   }
 
-  /* Continue HTML output. */
-  fputs(HTML_PROMPT_2, stdout); output_bridge(" onload='init()'"); fputs(HTML_PROMPT_3, stdout); output_end();
+  output_format("%s%s\r\n", fields, s); return 0;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
- * Read the contents of a query template (JSON) file into a character buffer.
+ * Hash the version (modification time and size) of a file, keeping track of the latest modification time.
  *   path:  file pathname
- *   string_ptr:  receives data read from file
- *     (memory for this buffer is obtained with malloc, and should be freed with free)
- * Return Value:  NULL on success; otherwise, an error message.
+ *   hash:  hash so far
+ *   time_ptr:  latest modification time so far (updated if the file is newer)
+ * Return Value:  Updated hash (which is unchanged if the file does not exist).
  */
-const char * read_templates(const char * path, char ** string_ptr)
+unsigned long hash_file(const char * path, unsigned long hash, time_t * time_ptr)
 {
   struct stat st;
-  FILE * f;
-  char * p;
-  int c;
 
-  /* Ensure that string_ptr can be safely passed to free. */
-  *string_ptr = NULL;
+  if (!strlen(path) || stat(path, &st)) return hash;
+  if (st.st_mtime > *time_ptr) *time_ptr = st.st_mtime;
+  hash = hash_bytes(hash, &st.st_mtime, sizeof(st.st_mtime));
+  return hash_bytes(hash, &st.st_size, sizeof(st.st_size));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Hash bytes (using 32-bit FNV-1a).
+ *   hash:  hash so far (HASH_BASIS to begin with)
+ *   buffer:  bytes to hash
+ *   size:  number of bytes to hash
+ * Return Value:  Updated hash.
+ */
+unsigned long hash_bytes(unsigned long hash, const void * buffer, size_t size)
+{
+  const unsigned char * p = buffer, * e = p + size;
+
+  while (p < e) hash = ((hash ^ *p++) * HASH_PRIME) & 0xFFFFFFFFUL;
+  return hash;
+}
 
-  /* Allocate memory for the buffer to store the data read from the file. */
-  if (stat(path, &st) || !(*string_ptr = malloc(2 * st.st_size + 1))) return strerror(errno);
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output an HTML document to prompt for a query.  The document depends only on this program and the script and query template
+ * files, so a cached copy remains valid as long as none of them have changed.  The query templates themselves are requested
+ * separately, from a URL that changes whenever the query template file does.
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   path:  pathname of query template (JSON) file
+ */
+void output_prompt(char * argv[], const char * path)
+{
+  unsigned long h, k;
+  time_t t = 0;
+
+  /* Derive the validators from the versions of this program and the files. */
+  h = hash_bytes(HASH_BASIS, STR_BUILD, strlen(STR_BUILD));
+  h = hash_file(argv[0], h, &t);
+  h = hash_file(argv[1], h, &t);
+  k = hash_file(path, HASH_BASIS, &t);
+  if (output_validators(STR_HTML_HEADER, hash_bytes(h, &k, sizeof(k)), t, STR_REVALIDATE)) return;
+
+  /* Begin HTML output. */
+  output_line("<!DOCTYPE html>"); output_begin(STR_PROMPT); output_string(HTML_PROMPT_1);
+
+  /* If a query template file was specified, request its contents (which should be JSON). */
+  if (strlen(path)) output_format(HTML_PROMPT_TEMPLATES_FORMAT, k, STR_TEMPLATES, STR_READING);
+
+  /* Continue HTML output. */
+  output_string(HTML_PROMPT_2); output_bridge(" onload='init()'"); output_string(HTML_PROMPT_3); output_end();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the contents of the query template (JSON) file.  If the file is requested by version (as the prompt does), the
+ * response can be cached indefinitely, since any change to the file results in a different version (and thus URL).
+ *   path:  pathname of query template (JSON) file
+ *   version:  version requested (which may be empty)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_templates(const char * path, const char * version)
+{
+  char s[BUFFER_SIZE];
+  unsigned long h;
+  time_t t = 0;
+  FILE * f;
+  size_t n;
 
   /* Open the file for reading. */
+  if (!strlen(path)) return STR_TEMPLATE;
   if (!(f = fopen(path, "rb"))) return strerror(errno);
 
-  /* Read the contents of the file into the buffer, excluding line terminators and escaping single quotes. */
-  for (p = *string_ptr; (c = fgetc(f)) != EOF;)
-    switch (c)
+  /* Output the header and (unless the response is 304) the contents of the file, a block at a time. */
+  sprintf(s, "%08lx", h = hash_file(path, HASH_BASIS, &t));
+  if (!output_validators(STR_JSON_HEADER, h, t, strcmp(version, s) ? STR_REVALIDATE : STR_IMMUTABLE))
+    while (n = fread(s, 1, sizeof(s), f)) output_write(s, n);
+  fclose(f); return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output an asset embedded in this program (e.g., Leaflet or the mapping script used by the results page).  If the asset is
+ * requested by version (as the results page does), the response can be cached indefinitely.  If the client accepts gzip
+ * encoding and the asset was embedded precompressed, the precompressed variant is output instead.  An unknown asset is "404
+ * Not Found" (which is never cached as the asset would be).
+ *   name:  asset name
+ *   version:  version requested (which may be NULL)
+ * Return Value:  NULL on success; otherwise, an error message (which has been output).
+ */
+const char * output_asset(const char * name, const char * version)
+{
+  char s[HEADER_MAX_LENGTH], v[0x10];
+  const struct asset * a;
+  const char * p;
+  int z;
+
+  /* Find the asset. */
+  for (a = ASSETS; a < ASSETS + ASSET_COUNT; ++a) if (!strcmp(a->name, name)) break;
+  if (a == ASSETS + ASSET_COUNT)
+  {
+    sprintf(s, "%s%s", STR_NOT_FOUND, STR_HTML_HEADER); output_header(s);
+    output_line("<!DOCTYPE html>"); output_begin(STR_ERROR); output_bridge("");
+    output_format("<h1>%s: ", STR_ERROR); output_html(STR_ASSET); output_string("</h1>"); output_end();
+    return STR_ASSET;
+  }
+
+  /* Determine which variant to output.  (Each has its own entity tag.) */
+  z = a->gzip_size && (p = getenv("HTTP_ACCEPT_ENCODING")) && strstr(p, "gzip");
+  sprintf(s, STR_ASSET_FORMAT, a->type, (unsigned long)(z ? a->gzip_size : a->size), z ? STR_GZIP : "");
+  sprintf(v, "%08lx", a->version);
+  if (output_validators(s, z ? hash_bytes(a->version, STR_GZIP, strlen(STR_GZIP)) : a->version, 0,
+                        (version && !strcmp(version, v)) ? STR_IMMUTABLE : STR_REVALIDATE)) return NULL;
+
+  /* The asset may be binary, so on Win32, standard output must be put in binary mode (lest "\n" be translated to "\r\n"). */
+  output_flush();
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  output_write(z ? a->gzip_data : a->data, z ? a->gzip_size : a->size);
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the results page, which requests the rows (with the same form data) and renders them as they arrive.
+ *   string:  decoded form data, or (if not form data) the query itself
+ *   length:  length of decoded form data (or query)
+ *   form:  nonzero if string is form data
+ */
+void output_results(char * string, size_t length, int form)
+{
+  char * p, * q, * e = string + length;
+  int c = 0;
+
+  output_header(STR_HTML_HEADER); output_line("<!DOCTYPE html>");
+  output_begin(STR_RESULTS); output_string(HTML_RESULTS_1);
+
+  /* The form data is embedded in the page as an array of name/value pairs (from which URLSearchParams can be constructed). */
+  output_string("<script>var request = [");
+  if (!form) { output_string("['q',"); output_json(string); output_char(']'); }
+  else for (p = string; p < e; p += strlen(p) + 1)
+  {
+    if (!*p) continue;
+    if (c++) output_char(',');
+    if (q = strchr(p, '=')) *q = '\0';
+    output_char('['); output_json(p); output_char(','); output_json(q ? q + 1 : ""); output_char(']');
+    if (q) *q = '=';
+  }
+  output_line("];</script>");
+
+  output_bridge(" onload='init()'"); output_string(HTML_RESULTS_2); output_end();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Execute the query (given in form data, or expanded from a template), and output the resulting rows as newline-delimited
+ * JSON:  an array of column names, followed by an array of values for each row, followed by an object that indicates either
+ * the number of rows ("rows") or an error message ("error").  Errors are thus reported within the response (after the header).
+ * For an export job, only the records (column names and rows) are output, either as JSON arrays or as CSV.  If form data
+ * includes a sample size as "sample", only a random sample of the rows (of that size) is output.
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ *   format:  FORMAT_STREAM, FORMAT_NDJSON, or FORMAT_CSV
+ *   count_ptr:  receives the number of rows (or NULL)
+ *   profile_ptr:  receives the times at which the phases of executing the query begin and end (or NULL)
+ * Return Value:  NULL on success; otherwise, an error message (which remains valid until this function is called again).
+ */
+const char * output_rows(struct script * script_ptr, char * form, size_t length, int format, long * count_ptr,
+                         struct profile * profile_ptr)
+{
+  struct shard_plan a;
+  struct shard_set s;
+  struct shard_scan d;
+  struct replica_set r;
+  const char * input[5], ** inputs[SHARD_MAX], * p = NULL;
+  char * t, * q, * y, * x = NULL, * w = "";
+  static char e[SOURCE_MESSAGE_MAX_LENGTH];
+  const char * command = script_ptr->commands[0];
+  int b = !strncmp(command, STR_SQLPLUS, strlen(STR_SQLPLUS)), n, i, j, k = 0, h, f[REPLICA_MAX], g = 0, u;
+  unsigned long m = 0;
+  long c = 0, z = 0;
+
+  if (profile_ptr) { profile_ptr->start = wall_time(); profile_ptr->started = 0; }
+  if (format == FORMAT_STREAM) output_header(STR_ROWS_HEADER);
+  a.buffer = d.buffer = d.plan.buffer = NULL; *e = '\0';
+
+  /* Form data must include either the query (i.e., the SQL SELECT statement) as "q", or the title of a query template as "t"
+   * (along with the template's parameters).  SQL*Plus binds parameter values to variables, so that the statement text is
+   * the same regardless of the values (and Oracle can reuse its cursor).
+   */
+  if (t = find_param(form, length, "t"))
+  {
+    p = expand_template(script_ptr->template_path, t, form, length, b, &x, &w, NULL); t = x;
+  }
+  else if (!(t = find_param(form, length, "q"))) p = STR_QUERY;
+
+  /* Verify that the query is a valid SQL SELECT statement.  If there are multiple shards, the same query is executed on
+   * each of them (at most a given number at once), and the results are combined as if by UNION ALL:  rows are output as
+   * each shard produces them, unless the query has an ORDER BY clause, in which case the (sorted) results of every shard
+   * are merged.  Any LIMIT and OFFSET are applied to the combined results.
+   */
+  if (!p && !(n = validate_query(t = jb_trim(t)))) p = STR_QUERY;
+  if (!p && script_ptr->command_count > 1 && !script_ptr->replicated && !(p = shard_plan(t, &a)) && a.query)
+    n = strlen(t = a.query);
+  if (!p && (q = find_param(form, length, "sample")) && *q && ((z = strtol(q, &y, 10)) < 1 || z > SHARD_SAMPLE_MAX || *y))
+    p = STR_SAMPLE;
+  if (profile_ptr) profile_ptr->prepared = wall_time();
+
+  /* Execute the query.  The database utility's input comprises any commands that must precede the query, followed by the
+   * query itself (terminated by a semicolon if it isn't already).  Each record that it outputs (the first of which is the
+   * column headings) is output as a JSON array.  Rows are sent as they are produced:  standard output is flushed whenever
+   * the utility's output must be awaited.
+   */
+  if (!p)
+  {
+    input[0] = b ? STR_SQLPLUS_COMMANDS : ""; input[1] = w; input[2] = t;
+    input[3] = (t[n - 1] == ';') ? "\n" : ";\n"; input[4] = NULL;
+    for (i = 0; i < script_ptr->command_count; ++i) inputs[i] = input;
+
+    /* SQLite sorts nulls first (whereas Oracle and PostgreSQL sort them last), and text byte by byte (unless it is collated
+     * otherwise), which matters when merging shards.
+     */
+    i = b ? SOURCE_SQLPLUS : (strncmp(command, STR_SQLITE, strlen(STR_SQLITE)) &&
+                              strncmp(command, STR_SPATIALITE, strlen(STR_SPATIALITE))) ? 0 : SHARD_NULLS_FIRST | SHARD_BINARY;
+    if (format == FORMAT_STREAM) i |= SOURCE_FLUSH;
+    u = (i & SHARD_NULLS_FIRST) ? SHARD_SAMPLE_ROWID : strncmp(command, STR_PSQL, strlen(STR_PSQL)) ? 0 : SHARD_SAMPLE_BERNOULLI;
+
+    /* A scan of a single SQLite table can be split into rowid ranges, each queried at once (if there are multiple workers).
+     * If the results are sampled, a scan of a single table reads only a sample of it (if the database can sample it); in
+     * any case, the sample is then drawn from the rows as they are read.
+     */
+    if (!script_ptr->replicated)
+    {
+      if (z && u && script_ptr->command_count == 1 && shard_sample(command, t, z, u, &d))
+        p = shard_open(&s, d.commands, d.inputs, 1, 1, i, &d.plan);
+      else if (!z && (i & SHARD_NULLS_FIRST) && script_ptr->command_count == 1 &&
+               (n = shard_scan(command, t, script_ptr->workers, &d)))
+        p = shard_open(&s, d.commands, d.inputs, n, n, i | d.flags, &d.plan);
+      else p = shard_open(&s, script_ptr->commands, inputs, script_ptr->command_count,
+                          script_ptr->workers ? script_ptr->workers : SHARD_WORKERS, i,
+                          (script_ptr->command_count > 1) ? &a : NULL);
+      if (!p && z) p = shard_reservoir(&s, z);
+      if (!p)
+      {
+        for (; (n = shard_read(&s)) > 0; ++c)
+        {
+          if (!c && profile_ptr) profile_ptr->started = wall_time();
+          if (format == FORMAT_CSV) output_csv(s.fields, n); else output_record(s.fields, n, 1);
+        }
+        p = shard_close(&s);
+      }
+    }
+
+    /* With replicas, the query is executed on one (chosen by the balance policy), and if it fails before anything is
+     * output, it is retried on another.  A replica is deemed unhealthy (and ejected) only if its failure was not shared:
+     * i.e., another replica then succeeded (or at least output something), or failed differently.  If two replicas fail
+     * the same way in a row, the query itself is presumed to be at fault, and it is not retried.
+     */
+    else
+    {
+      replica_open(&r, script_ptr->commands, script_ptr->command_count, script_ptr->balance);
+      for (h = REPLICA_UNKNOWN; (k = replica_acquire(&r, m)) >= 0; m |= 1UL << k)
+      {
+        if (!(p = shard_open(&s, script_ptr->commands + k, inputs, 1, 1, i, NULL)) && z) p = shard_reservoir(&s, z);
+        if (!p)
+        {
+          for (; (n = shard_read(&s)) > 0; ++c)
+          {
+            if (!c && profile_ptr) profile_ptr->started = wall_time();
+            if (format == FORMAT_CSV) output_csv(s.fields, n); else output_record(s.fields, n, 1);
+          }
+          p = shard_close(&s);
+        }
+        if (!p || c) { h = REPLICA_UNHEALTHY; replica_release(&r, k, p ? REPLICA_UNKNOWN : REPLICA_HEALTHY); break; }
+        if (!strcmp(p, e)) { h = REPLICA_UNKNOWN; replica_release(&r, k, h); break; }
+        strcpy(e, p); p = e; f[g++] = k; h = (g > 1) ? REPLICA_UNHEALTHY : REPLICA_UNKNOWN;
+      }
+      for (j = 0; j < g; ++j) replica_release(&r, f[j], h);
+      replica_close(&r);
+    }
+  }
+  free(a.buffer); free(d.buffer); free(d.plan.buffer); free(x);
+  if (profile_ptr)
+  {
+    profile_ptr->fetched = wall_time();
+    if (!profile_ptr->started) profile_ptr->started = profile_ptr->fetched;
+  }
+
+  /* An error message may be kept by the shard set (which is gone once this function returns), so it is copied. */
+  if (p && p != e) p = strcpy(e, p);
+  if (count_ptr) *count_ptr = c ? c - 1 : 0;
+  if (format != FORMAT_STREAM) return p;
+  if (p) { output_string("{\"error\":"); output_json(p); output_line("}"); }
+  else output_format("{\"rows\":%ld%s}\n", c ? c - 1 : 0, z ? ",\"sampled\":true" : "");
+  return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the rows of a query, from a snapshot if the query is a template query whose results are kept as one.  A snapshot is
+ * made the first time it is requested, and thereafter output as is (with an Age header), even if it is stale:  a request
+ * for a stale snapshot instead spawns a process to refresh it, unless one is already doing so.  Thus the query is executed
+ * at most once at a time, and (once there is a snapshot) the client never waits for it.  If the snapshot is being made when
+ * it is requested, or the query has no snapshot, the query is simply executed (by output_rows).
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_snapshot(char * argv[], struct script * script_ptr, char * form, size_t length)
+{
+  char s[BUFFER_SIZE], h[HEADER_MAX_LENGTH], i[SNAPSHOT_ID_LENGTH + 1];
+  struct snapshot n;
+  const char * p;
+  long a, w;
+  size_t k;
+  FILE * f;
+  int m;
+
+  if (!(w = find_snapshot(script_ptr, form, length, i, NULL)) || snapshot_open(&n, script_key(argv[1]), i))
+    return output_rows(script_ptr, form, length, FORMAT_STREAM, NULL, NULL);
+
+  /* If there is no snapshot yet, it is made now (unless another process got there first).  The form data is kept (while the
+   * snapshot is locked), so that the snapshot can be refreshed later.
+   */
+  if ((a = snapshot_age(&n)) < 0)
+  {
+    if (!snapshot_lock(&n)) return output_rows(script_ptr, form, length, FORMAT_STREAM, NULL, NULL);
+    if ((a = snapshot_age(&n)) < 0 && snapshot_keep(&n, form, length))
+    {
+      snapshot_unlock(&n); return output_rows(script_ptr, form, length, FORMAT_STREAM, NULL, NULL);
+    }
+    m = (a < 0) ? 1 : match_snapshot(script_ptr, form, length, &n);
+    p = (a < 0) ? make_snapshot(script_ptr, form, length, &n) : NULL;
+    snapshot_unlock(&n);
+    if (p) { output_header(STR_ROWS_HEADER); output_string("{\"error\":"); output_json(p); output_line("}"); return p; }
+    if (a < 0) a = 0;
+  }
+
+  /* Otherwise, the snapshot must be of the query requested (since its ID is only a hash), lest the form data of another
+   * query be replaced.  If it is stale (and no other process is refreshing it), a process is spawned to refresh it.  The
+   * form data is kept while the snapshot is locked, so that the process never reads it partially.
+   */
+  else if ((m = match_snapshot(script_ptr, form, length, &n)) && a >= w && snapshot_lock(&n))
+  {
+    p = snapshot_keep(&n, form, length); snapshot_unlock(&n);
+    if (!p) snapshot_spawn(&n, argv);
+  }
+
+  /* Output the snapshot, a block at a time.  (It is replaced, rather than rewritten, by a refresh.)  If it is not of the query
+   * requested, the query is executed instead.
+   */
+  if (!m || !snapshot_path(&n, SNAPSHOT_OUTPUT) || !(f = fopen(n.path, "rb")))
+    return output_rows(script_ptr, form, length, FORMAT_STREAM, NULL, NULL);
+  sprintf(h, STR_AGE_FORMAT, STR_ROWS_HEADER, a); output_header(h);
+  while (k = fread(s, 1, sizeof(s), f)) output_write(s, k);
+  fclose(f); return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Make (or refresh) a snapshot:  execute the query, and output the resulting rows (as output_rows does for the results
+ * page) to the snapshot.
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ *   snapshot_ptr:  snapshot (which should be locked)
+ * Return Value:  NULL on success; otherwise, an error message (in which case any previous snapshot remains).
+ */
+const char * make_snapshot(struct script * script_ptr, char * form, size_t length, struct snapshot * snapshot_ptr)
+{
+  const char * p;
+  long c;
+
+  if (p = snapshot_begin(snapshot_ptr)) return p;
+  if (!(p = output_rows(script_ptr, form, length, FORMAT_NDJSON, &c, NULL))) output_format("{\"rows\":%ld}\n", c);
+  return snapshot_end(snapshot_ptr, p);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Profile a query (given in form data, or expanded from a template), so that a slow one can be diagnosed from the browser:
+ * execute it as for the results page (but discard the rows), then obtain its plan from the database utility, and output a
+ * web page with the query, its plan, how long each phase took (in milliseconds), and how many rows and bytes were output.
+ * If there are multiple shards (or replicas), the plan is obtained from the first (on PostgreSQL, by a second execution).
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ * Return Value:  NULL on success; otherwise, an error message (which is shown on the page).
+ */
+const char * output_profile(struct script * script_ptr, char * form, size_t length)
+{
+  struct profile f;
+  struct shard_set s;
+  const char * input[6], ** inputs[1], * command = script_ptr->commands[0], * p, * e = NULL, * l = STR_PLAN;
+  char * t, * x = NULL, * w = "";
+  double a, z;
+  size_t k = 0;
+  long c = 0;
+  int n = 0, i, j;
+
+  /* Execute the query, counting the bytes that would be output (to the results page). */
+  memset(&f, 0, sizeof(f));
+  if (!(p = output_open(STR_NULL_DEVICE)))
+  {
+    p = output_rows(script_ptr, form, length, FORMAT_NDJSON, &c, &f);
+    k = output_count(); output_close();
+  }
+
+  /* The plan is obtained for the query as it was executed (but without bind variables, which SQL*Plus would need).  On
+   * PostgreSQL, EXPLAIN ANALYZE executes the query a second time (which is labeled as such, apart from the timings above).
+   */
+  if (t = find_param(form, length, "t"))
+  {
+    e = expand_template(script_ptr->template_path, t, form, length, 0, &x, &w, NULL); t = x;
+  }
+  else if (!(t = find_param(form, length, "q"))) e = STR_QUERY;
+  if (!e && !(n = validate_query(t = jb_trim(t)))) e = STR_QUERY;
+  if (!strncmp(command, STR_PSQL, strlen(STR_PSQL))) { input[1] = STR_PSQL_EXPLAIN; l = STR_PLAN_ANALYZE; }
+  else if (!strncmp(command, STR_SQLITE, strlen(STR_SQLITE)) || !strncmp(command, STR_SPATIALITE, strlen(STR_SPATIALITE)))
+    input[1] = STR_SQLITE_EXPLAIN;
+  else if (!e) e = STR_EXPLAIN;
+
+  output_header(STR_HTML_HEADER); output_line("<!DOCTYPE html>");
+  output_begin(STR_PROFILE); output_string(HTML_PROFILE); output_bridge("");
+  output_format("<h1>%s</h1><h2>Query</h2><pre>", STR_PROFILE);
+  if (t) output_html(t);
+  output_line("</pre>");
+
+  /* The plan is output as a table, with a row for each record (the first of which is the column headings). */
+  output_format("<h2>%s</h2>", l); a = wall_time();
+  if (!e)
+  {
+    input[0] = w; input[2] = t; input[3] = (t[n - 1] == ';') ? "\n" : ";\n"; input[4] = NULL; inputs[0] = input;
+    if (!(e = shard_open(&s, &command, inputs, 1, 1, 0, NULL)))
+    {
+      for (output_string("<table>"), j = 0; (n = shard_read(&s)) > 0; ++j)
+      {
+        for (output_string("<tr>"), i = 0; i < n; ++i)
+        {
+          output_string(j ? "<td>" : "<th>"); output_html(s.fields[i]); output_string(j ? "</td>" : "</th>");
+        }
+        output_line("</tr>");
+      }
+      output_line("</table>");
+      e = shard_close(&s);
+    }
+  }
+  z = wall_time();
+  if (e) { output_format("<p>%s: ", STR_ERROR); output_html(e); output_line("</p>"); }
+
+  /* The phases of executing the query (as recorded by output_rows) are followed by what it output. */
+  output_string("<h2>Timings</h2><table><tr><th>Phase</th><th>Milliseconds</th></tr>");
+  output_format(STR_TIMING_FORMAT, "Prepare (expand and verify)", (f.prepared - f.start) * 1000);
+  output_format(STR_TIMING_FORMAT, "Start (until first record)", (f.started - f.prepared) * 1000);
+  output_format(STR_TIMING_FORMAT, "Fetch (remaining records)", (f.fetched - f.started) * 1000);
+  output_format(STR_TIMING_FORMAT, "Total", (f.fetched - f.start) * 1000);
+  output_format(STR_TIMING_FORMAT, l, (z - a) * 1000);
+  output_format("</table><h2>Output</h2><table><tr><th>Rows</th><td class='n'>%ld</td></tr>"
+                "<tr><th>Bytes</th><td class='n'>%lu</td></tr></table>", c, (unsigned long)k);
+  if (p && (!e || strcmp(p, e))) { output_format("<p>%s: ", STR_ERROR); output_html(p); output_line("</p>"); }
+  output_end();
+
+  free(x); return p ? p : e;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Execute a batch of queries (each given in form data as "q") concurrently, and output the results of all of them in one
+ * JSON object:  "results" is an array with an object for each query (in order), which has "columns" (the column names)
+ * and "rows" (an array of values for each row) if the query was executed, and "error" (an error message) if it failed.
+ * An error in one query does not affect the others.  (If the batch itself is not valid, the object has only "error".)
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ * Return Value:  NULL on success; otherwise, an error message (for the batch as a whole).
+ */
+const char * output_batch(struct script * script_ptr, char * form, size_t length)
+{
+  struct shard_plan a[BATCH_MAX];
+  struct shard_set s[BATCH_MAX];
+  struct replica_set r;
+  const char * input[BATCH_MAX][5], ** inputs[BATCH_MAX][SHARD_MAX], * e[BATCH_MAX], ** commands = script_ptr->commands;
+  char * t[BATCH_MAX], * q, * f = form + length;
+  const char * command = script_ptr->commands[0];
+  int b = !strncmp(command, STR_SQLPLUS, strlen(STR_SQLPLUS)), n, i, j, g, h = REPLICA_HEALTHY, k = -1;
+  int m = script_ptr->replicated ? 1 : script_ptr->command_count;
+  long c;
+
+  output_header(STR_JSON_HEADER);
+
+  /* Find the queries. */
+  for (n = 0, q = form; q < f && (q = find_param(q, f - q, "q")); q += strlen(q) + 1)
+  {
+    if (n == BATCH_MAX) { n = 0; break; }
+    t[n++] = q;
+  }
+  if (!n) { output_string("{\"error\":"); output_json(STR_BATCH); output_line("}"); return STR_BATCH; }
+
+  /* With replicas, all of the queries are executed on the same one (chosen by the balance policy, without failover). */
+  if (script_ptr->replicated)
+  {
+    replica_open(&r, script_ptr->commands, script_ptr->command_count, script_ptr->balance);
+    commands += k = replica_acquire(&r, 0);
+  }
+  g = b ? SOURCE_SQLPLUS : (strncmp(command, STR_SQLITE, strlen(STR_SQLITE)) &&
+                            strncmp(command, STR_SPATIALITE, strlen(STR_SPATIALITE))) ? 0 : SHARD_NULLS_FIRST | SHARD_BINARY;
+
+  /* Verify that each query is valid, and start executing it (as for output_rows).  The output of each database utility is
+   * spooled, so that every query can run to completion while the results of those before it are output.
+   */
+  for (i = 0; i < n; ++i)
+  {
+    a[i].buffer = NULL; e[i] = NULL; memset(s + i, 0, sizeof(struct shard_set));
+    if (!(j = validate_query(t[i] = jb_trim(t[i])))) { e[i] = STR_QUERY; continue; }
+    if (m > 1 && !(e[i] = shard_plan(t[i], a + i)) && a[i].query) j = strlen(t[i] = a[i].query);
+    if (e[i]) continue;
+    input[i][0] = b ? STR_SQLPLUS_COMMANDS : ""; input[i][1] = ""; input[i][2] = t[i];
+    input[i][3] = (t[i][j - 1] == ';') ? "\n" : ";\n"; input[i][4] = NULL;
+    for (j = 0; j < m; ++j) inputs[i][j] = input[i];
+    if (!(e[i] = shard_open(s + i, commands, inputs[i], m, script_ptr->workers ? script_ptr->workers : SHARD_WORKERS,
+                            g | SOURCE_SPOOL, (m > 1) ? a + i : NULL))) e[i] = shard_start(s + i);
+  }
+
+  /* Output the results of each query in turn. */
+  for (output_string("{\"results\":["), i = 0; i < n; ++i)
+  {
+    if (i) output_char(',');
+    if (!e[i])
+    {
+      for (c = 0; (j = shard_read(s + i)) > 0; ++c)
+      {
+        output_string(c ? (c > 1 ? "," : "") : "{\"columns\":");
+        output_record(s[i].fields, j, 0);
+        if (!c) output_string(",\"rows\":[");
+      }
+      e[i] = shard_close(s + i);
+      if (c) output_char(']');
+    }
+    else { shard_close(s + i); c = 0; }
+    if (e[i]) { output_string(c ? ",\"error\":" : "{\"error\":"); output_json(e[i]); h = REPLICA_UNKNOWN; }
+    else if (!c) output_string("{\"columns\":[],\"rows\":[]");
+    output_line("}");
+    free(a[i].buffer);
+  }
+  output_line("]}");
+
+  if (k >= 0) replica_release(&r, k, h);
+  if (script_ptr->replicated) replica_close(&r);
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Create a job to execute the query (given in form data, as for output_rows) and write the results to a file, and spawn a
+ * worker to execute it.  The response (202 Accepted) is output at once, with the ID of the job, by which the client then
+ * asks about the job and, once it is done, downloads the results (see output_job).
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   form:  decoded form data, which may specify the format of the results as "format" (csv, the default, or ndjson)
+ *   length:  length of decoded form data
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_export(char * argv[], char * form, size_t length)
+{
+  char h[HEADER_MAX_LENGTH];
+  const char * f = find_param(form, length, "format"), * p = NULL;
+  struct job j;
+
+  if (!f || !*f) f = STR_CSV;
+  else if (strcmp(f, STR_CSV) && strcmp(f, STR_NDJSON)) p = STR_FORMAT;
+  if (!p && !(p = job_create(&j, script_key(argv[1]), form, length, f)) && (p = job_spawn(&j, argv)))
+    job_status(&j, STR_FAILED, f, p);
+
+  sprintf(h, "%s%s", p ? ((p == STR_FORMAT) ? STR_BAD_REQUEST : STR_UNAVAILABLE) : STR_ACCEPTED, STR_JSON_HEADER);
+  output_header(h);
+  if (p) { output_string("{\"error\":"); output_json(p); output_line("}"); }
+  else output_format("{\"job\":\"%s\",\"state\":\"queued\"}\n", j.id);
+  return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output the status of a job (as JSON), or (once the job is done) download its results.  The status comprises the state
+ * ("queued", "running", "done", or "failed"), the format, the number of rows (if the job is done) or an error message (if
+ * it failed), and the size in bytes of the results so far.  A download can be limited to a single range of bytes (e.g., to
+ * resume an interrupted download), in which case the response is 206 (Partial Content).
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   id:  job ID (or NULL)
+ *   download:  nonzero if the results are to be downloaded
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_job(char * argv[], const char * id, int download)
+{
+  char h[HEADER_MAX_LENGTH], b[BUFFER_SIZE], * s = NULL, * f, * o;
+  const char * p = NULL;
+  struct stat st;
+  struct job j;
+  long n, first = 0, last;
+  size_t k;
+  int r;
+  FILE * g = NULL;
+
+  /* The job must exist, and its results can be downloaded only once it is done. */
+  if (!id || job_open(&j, script_key(argv[1]), id) || !(s = job_state(&j, &f, &o))) p = STR_JOB;
+  else
+  {
+    r = !job_path(&j, JOB_OUTPUT) || stat(j.path, &st);
+    if (download && (r || strcmp(s, STR_DONE))) p = STR_JOB_PENDING;
+    else if (download && !(g = fopen(j.path, "rb"))) p = strerror(errno);
+  }
+  if (p)
+  {
+    sprintf(h, "%s%s", s ? STR_CONFLICT : STR_NOT_FOUND, STR_JSON_HEADER); output_header(h);
+    output_string("{\"error\":"); output_json(p); output_line("}"); free(s); return p;
+  }
+
+  if (!download)
+  {
+    output_header(STR_JSON_HEADER);
+    output_format("{\"job\":\"%s\",\"state\":", j.id); output_json(s); output_string(",\"format\":"); output_json(f);
+    if (!strcmp(s, STR_DONE)) output_format(",\"rows\":%ld", strtol(o, NULL, 10));
+    else if (!strcmp(s, STR_FAILED)) { output_string(",\"error\":"); output_json(o); }
+    if (!r) output_format(",\"bytes\":%ld", (long)st.st_size);
+    output_line("}"); free(s); return NULL;
+  }
+
+  /* Determine which bytes to output (all of them, unless a satisfiable range is requested). */
+  last = (n = (long)st.st_size) - 1;
+  if ((r = parse_range(getenv("HTTP_RANGE"), n, &first, &last)) < 0)
+  {
+    sprintf(h, STR_UNSATISFIABLE_FORMAT, n); output_header(h); free(s); fclose(g); return NULL;
+  }
+  k = sprintf(h, "%s", r ? STR_PARTIAL : "");
+  k += sprintf(h + k, STR_DOWNLOAD_FORMAT, strcmp(f, STR_CSV) ? STR_ROWS_HEADER : STR_CSV_HEADER, last - first + 1, j.id, f);
+  if (r) sprintf(h + k, STR_RANGE_FORMAT, first, last, n);
+  output_header(h); free(s);
+
+  /* Output the bytes a block at a time.  (On Win32, standard output must be put in binary mode, as for output_asset.) */
+  output_flush();
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+  if (first && fseek(g, first, SEEK_SET)) p = strerror(errno);
+  else for (n = last - first + 1; n > 0 && (k = fread(b, 1, (n < BUFFER_SIZE) ? n : BUFFER_SIZE, g)); n -= k)
+    output_write(b, k);
+  fclose(g); return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parse the value of the Range header field of a request for a file.  Only a single range of bytes is supported:  any other
+ * value (e.g., multiple ranges) is ignored, as HTTP allows, so that the whole file is output.
+ *   range:  value of the Range header field (or NULL if there is none)
+ *   size:  size of the file
+ *   first_ptr:  receives the offset of the first byte in the range
+ *   last_ptr:  receives the offset of the last byte in the range
+ * Return Value:  1 if the range is satisfiable, -1 if it is not (i.e., it begins beyond the end of the file), or zero if it
+ *   is to be ignored.
+ */
+int parse_range(const char * range, long size, long * first_ptr, long * last_ptr)
+{
+  const char * p;
+  char * e;
+  long a, b;
+
+  if (!range || strncmp(range, "bytes=", 6) || strchr(range, ',')) return 0;
+  p = range + 6;
+
+  /* A suffix range (e.g., "-500") comprises the last bytes of the file. */
+  if (*p == '-')
+  {
+    if (!isdigit(p[1]) || (b = strtol(p + 1, &e, 10), *e)) return 0;
+    if (!b || !size) return -1;
+    *first_ptr = (b < size) ? size - b : 0; *last_ptr = size - 1; return 1;
+  }
+
+  /* Otherwise, the range has a first byte, and may have a last byte (or else extends to the end of the file). */
+  if (!isdigit(*p) || (a = strtol(p, &e, 10), *e != '-')) return 0;
+  if (!e[1]) b = size - 1;
+  else if (!isdigit(e[1]) || (b = strtol(e + 1, &e, 10), *e) || b < a) return 0;
+  if (a >= size) return -1;
+  *first_ptr = a; *last_ptr = (b < size) ? b : size - 1; return 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Execute a job (as a worker, spawned by output_export), once a worker slot is available, writing the results to a file.
+ * Since the worker is detached, the outcome (number of rows or error message) is noted in the status of the job.
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   id:  job ID
+ * Return Value:  Exit status (EXIT_SUCCESS or EXIT_FAILURE).
+ */
+int execute_job(char * argv[], const char * id)
+{
+  char * s = NULL, c[0x20];
+  const char * p, * f, * e;
+  struct script t;
+  struct job j;
+  size_t m;
+  long n = 0;
+  FILE * g;
+
+  /* The job must exist (or else there is nowhere to note the outcome). */
+  p = read_file(argv, &g, &t);
+  if (g) fclose(g);
+  if (job_open(&j, script_key(argv[1]), id) || !(s = job_read(&j, JOB_FORM, &m))) { free(t.buffer); return EXIT_FAILURE; }
+  f = find_param(s, m, "format");
+  if (!f || strcmp(f, STR_NDJSON)) f = STR_CSV;
+
+  /* Wait for a worker slot, and then execute the query, with standard output redirected to the results file. */
+  if (!p) { job_wait(&j); p = job_status(&j, STR_RUNNING, f, ""); }
+  if (!p && !(p = job_path(&j, JOB_OUTPUT) ? output_open(j.path) : strerror(errno)))
+  {
+    p = output_rows(&t, s, m, (f == STR_CSV) ? FORMAT_CSV : FORMAT_NDJSON, &n, NULL);
+    if ((e = output_close()) && !p) p = e;
+  }
+
+  if (p) job_status(&j, STR_FAILED, f, p);
+  else { sprintf(c, "%ld", n); job_status(&j, STR_DONE, f, c); }
+  job_release(&j); free(s); free(t.buffer);
+  return p ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Refresh a snapshot (as a process spawned by output_snapshot), with the form data kept for it, unless another process is
+ * already doing so.  The snapshot is refreshed only if it is still stale (i.e., no other process has refreshed it since).
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   id:  snapshot ID
+ * Return Value:  Exit status.
+ */
+int execute_snapshot(char * argv[], const char * id)
+{
+  char * s = NULL, i[SNAPSHOT_ID_LENGTH + 1];
+  const char * p;
+  struct script t;
+  struct snapshot n;
+  size_t m;
+  long w, a;
+  FILE * g;
+
+  p = read_file(argv, &g, &t);
+  if (g) fclose(g);
+  if (p || snapshot_open(&n, script_key(argv[1]), id) || !snapshot_lock(&n)) { free(t.buffer); return EXIT_FAILURE; }
+
+  /* The form data must still identify the snapshot (i.e., the template must not have changed so as to expand differently). */
+  if (!(s = snapshot_read(&n, &m))) p = strerror(errno);
+  else if ((w = find_snapshot(&t, s, m, i, NULL)) && !strcmp(i, n.id) && ((a = snapshot_age(&n)) < 0 || a >= w))
+    p = make_snapshot(&t, s, m, &n);
+  snapshot_unlock(&n); free(s); free(t.buffer);
+  return p ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Warm the caches (e.g., after a deployment or a nightly load), so that the first users do not wait on cold databases:
+ * execute every query listed in a manifest file.  The snapshot of each query whose results are kept as one is made (or
+ * refreshed, whatever its age); the results of any other query are discarded (but what it read is then cached by the
+ * database).  Each line of the manifest is form data, as in a query string (e.g., "t=Tables+(including+comments)"), and
+ * lines that are blank or begin with "#" are ignored.  A parameter value that is a range of integers ("first..last") stands
+ * for each integer in the range, and a line with several ranges stands for every combination of them (e.g., each map tile
+ * in a block:  "t=Parcels&z=12&x=1200..1215&y=1500..1515"), up to WARM_MAX combinations.  The queries are executed at once,
+ * by as many processes as the Workers line allows (or SHARD_WORKERS).  On Win32 (where processes cannot be forked), they are
+ * executed in turn.
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   path:  pathname of manifest file
+ * Return Value:  Exit status.
+ */
+int warm_caches(char * argv[], const char * path)
+{
+  struct script t;
+  struct stat st;
+  char * s = NULL, * b = NULL, * p, * q, * e, * r, * d, * v[TEMPLATE_PARAM_MAX + 1];
+  const char * y;
+  long first[TEMPLATE_PARAM_MAX + 1], last[TEMPLATE_PARAM_MAX + 1], x[TEMPLATE_PARAM_MAX + 1], u;
+  int l = 0, c = 0, f = 0, k, j, w;
+  size_t n;
+  FILE * g;
+#ifndef _WIN32
+  int a = 0, i;
+  pid_t z;
+#endif
+
+  /* Read the script file and the manifest. */
+  y = read_file(argv, &g, &t);
+  if (g) fclose(g);
+  if (!y && (stat(path, &st) || !(s = jb_file_read(path, st.st_size)))) y = strerror(errno);
+  if (y) { fprintf(stderr, "%s\n", y); free(t.buffer); return EXIT_FAILURE; }
+  s[st.st_size] = '\0';
+  w = t.workers ? t.workers : SHARD_WORKERS;
+
+  for (p = s; p; p = q)
+  {
+    /* Decode each line in place (into name/value pairs, each terminated by a null byte), and find any ranges in it. */
+    if (q = strchr(p, '\n')) *q++ = '\0';
+    ++l; p = jb_trim(p);
+    if (!*p || *p == '#') continue;
+    e = p; n = url_decode(p, &e, p + strlen(p), 1) - p; p[n] = '\0';
+    for (k = 0, r = p; r < p + n; r += strlen(r) + 1)
+    {
+      if (!(d = strchr(r, '=')) || !warm_range(d + 1, first + k, last + k)) continue;
+      if (k == TEMPLATE_PARAM_MAX) break;
+      x[k] = first[k]; v[k++] = r;
+    }
+    if (r < p + n) { fprintf(stderr, STR_WARM_FORMAT, path, l, STR_RANGES); ++f; continue; }
+    for (u = 1, j = 0; j < k && last[j] - first[j] < WARM_MAX / u; ++j) u *= last[j] - first[j] + 1;
+    if (j < k) { fprintf(stderr, STR_WARM_FORMAT, path, l, STR_COMBINATIONS); ++f; continue; }
+    if (!(d = realloc(b, n + 0x20 * k + 1))) { fprintf(stderr, STR_WARM_FORMAT, path, l, strerror(errno)); ++f; continue; }
+    b = d;
+
+    for (;;)
+    {
+      /* Compose the form data for this combination of range values. */
+      for (d = b, r = p, j = 0; r < p + n; r += strlen(r) + 1)
+        if (j < k && r == v[j]) { d += sprintf(d, "%.*s=%ld", (int)(strchr(r, '=') - r), r, x[j]) + 1; ++j; }
+        else { strcpy(d, r); d += strlen(r) + 1; }
+      ++c;
+
+#ifdef _WIN32
+      if (y = warm_query(&t, b, d - b, script_key(argv[1]))) { fprintf(stderr, STR_WARM_FORMAT, path, l, y); ++f; }
+#else
+      /* Each query is executed by a child process, once fewer than the maximum number are executing. */
+      for (; a >= w; --a) if (wait(&i) > 0 && (!WIFEXITED(i) || WEXITSTATUS(i))) ++f;
+      if ((z = fork()) < 0) { fprintf(stderr, STR_WARM_FORMAT, path, l, strerror(errno)); ++f; }
+      else if (z) ++a;
+      else
+      {
+        if (y = warm_query(&t, b, d - b, script_key(argv[1]))) fprintf(stderr, STR_WARM_FORMAT, path, l, y);
+        _exit(y ? EXIT_FAILURE : EXIT_SUCCESS);
+      }
+#endif
+
+      /* Move on to the next combination (if any). */
+      for (j = k - 1; j >= 0 && x[j] == last[j]; --j) x[j] = first[j];
+      if (j < 0) break;
+      ++x[j];
+    }
+  }
+
+#ifndef _WIN32
+  for (; a > 0; --a) if (wait(&i) > 0 && (!WIFEXITED(i) || WEXITSTATUS(i))) ++f;
+#endif
+  printf(STR_WARMED_FORMAT, c, f);
+  free(b); free(s); free(t.buffer);
+  return f ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Warm the caches for one query (see warm_caches).
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ *   key:  identifies the script file (whose snapshots are kept together)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * warm_query(struct script * script_ptr, char * form, size_t length, unsigned long key)
+{
+  char i[SNAPSHOT_ID_LENGTH + 1];
+  struct snapshot n;
+  const char * p, * e;
+
+  /* A snapshot is made (or refreshed), unless another process is already doing so.  (See output_snapshot.) */
+  if (find_snapshot(script_ptr, form, length, i, NULL) && !snapshot_open(&n, key, i))
+  {
+    if (snapshot_age(&n) < 0 && (p = snapshot_keep(&n, form, length))) return p;
+    if (!snapshot_lock(&n)) return NULL;
+    p = make_snapshot(script_ptr, form, length, &n);
+    snapshot_unlock(&n); return p;
+  }
+
+  /* Otherwise, the query is executed, and its results are discarded. */
+  if (p = output_open(STR_NULL_DEVICE)) return p;
+  p = output_rows(script_ptr, form, length, FORMAT_NDJSON, NULL, NULL);
+  return ((e = output_close()) && !p) ? e : p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parse a range of integers in a manifest (see warm_caches).
+ *   value:  parameter value
+ *   first_ptr:  receives the first integer in the range
+ *   last_ptr:  receives the last integer in the range
+ * Return Value:  Nonzero if the value is a range (i.e., "first..last", where first is no greater than last); otherwise, zero.
+ */
+int warm_range(const char * value, long * first_ptr, long * last_ptr)
+{
+  char * p;
+
+  if (!isdigit(*value)) return 0;
+  *first_ptr = strtol(value, &p, 10);
+  if (strncmp(p, "..", 2) || !isdigit(p[2])) return 0;
+  *last_ptr = strtol(p + 2, &p, 10);
+  return !*p && *first_ptr <= *last_ptr;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a record (i.e., column headings or row values) as a JSON array.
+ *   fields:  array of field values
+ *   count:  number of fields
+ *   line:  nonzero if the array is to be on its own line (i.e., followed by a newline)
+ */
+void output_record(char ** fields, int count, int line)
+{
+  int i;
+
+  output_char('[');
+  for (i = 0; i < count; ++i) { if (i) output_char(','); output_json(fields[i]); }
+  output_string(line ? "]\n" : "]");
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a record (i.e., column headings or row values) as a line of CSV.  A field that contains a comma, double quote, or
+ * line break is enclosed in double quotes (with any double quotes doubled).
+ *   fields:  array of field values
+ *   count:  number of fields
+ */
+void output_csv(char ** fields, int count)
+{
+  int i;
+
+  for (i = 0; i < count; ++i) { if (i) output_char(','); output_csv_value(fields[i]); }
+  output_write("\r\n", 2);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Expand a query template into a query, substituting the value of each parameter for its placeholder.  A value substituted
+ * within a string literal has its single quotes doubled; a value substituted anywhere else must be an identifier (e.g., a
+ * table or column name).  If bind variables are to be used, a placeholder that constitutes an entire string literal is
+ * replaced with a bind variable (declared and assigned in SQL*Plus commands preceding the query) instead.
+ *   path:  pathname of query template (JSON) file
+ *   title:  title of query template
+ *   string:  decoded form data containing parameter values
+ *   length:  length of decoded form data
+ *   bind:  nonzero if bind variables are to be used (for SQL*Plus)
+ *   query_ptr:  receives query, followed (after its terminating null byte) by commands that must precede it
+ *     (memory for this buffer is obtained with malloc, and should be freed with free)
+ *   commands_ptr:  receives pointer to commands that must precede the query (which may be an empty string)
+ *   snapshot_ptr:  receives the number of seconds for which a snapshot of the results is fresh, or zero if the results are
+ *     not kept as a snapshot (or NULL)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * expand_template(const char * path, const char * title, char * string, size_t length,
+                             int bind, char ** query_ptr, char ** commands_ptr, long * snapshot_ptr)
+{
+  struct template t;
+  struct stat st;
+  const char * values[TEMPLATE_PARAM_MAX], * p;
+  char * s, * d, * r;
+  int bound[TEMPLATE_PARAM_MAX], c, i;
+  size_t n, k;
+
+  /* Ensure that query_ptr can be safely passed to free. */
+  *query_ptr = NULL;
+
+  /* Read the query template file, and find the template with the given title. */
+  if (!strlen(path)) return STR_TEMPLATE;
+  if (stat(path, &st) || !(s = jb_file_read(path, st.st_size))) return strerror(errno);
+  s[st.st_size] = '\0';
+  if (p = find_template(s, title, &t)) { free(s); return p; }
+  if (snapshot_ptr) *snapshot_ptr = t.snapshot;
+
+  /* Look up the value of each parameter, and determine how much memory is needed for the expanded query (allowing for
+   * every placeholder in the format, with every single quote doubled, and a bind variable declaration for each value).
+   */
+  for (n = (k = strlen(t.format)) + 0x40, i = 0; i < t.param_count; ++i)
+  {
+    if (!(values[i] = find_param(string, length, t.params[i]))) { free(s); return STR_PARAM; }
+    n += (k / (strlen(t.params[i]) + 2) + 1) * (2 * strlen(values[i]) + 0x40);
+    bound[i] = 0;
+  }
+  if (!(*query_ptr = d = malloc(n))) { free(s); return strerror(errno); }
+
+  /* Copy the format to the query, keeping track of whether or not we're within a string literal, and substituting the
+   * value of each parameter for its placeholder.
+   */
+  for (c = 0, r = t.format; *r;)
+  {
+    if (*r == '\'') c = !c;
+
+    /* Determine whether or not this is a placeholder (and if so, for which parameter). */
+    if (*r == '{')
+      for (i = 0; i < t.param_count; ++i) if (!strncmp(r + 1, t.params[i], k = strlen(t.params[i])) && r[k + 1] == '}') break;
+    if (*r != '{' || i == t.param_count) { *d++ = *r++; continue; }
+    p = values[i]; r += k + 2;
+
+    /* If the placeholder is an entire string literal, its value may be bound to a variable instead. */
+    if (bind && c && r[-k - 3] == '\'' && (r - k - 3 == t.format || r[-k - 4] != '\'') && *r == '\''
+        && strlen(p) <= BIND_VALUE_MAX && !strpbrk(p, "\r\n"))
+    {
+      d += sprintf(d - 1, ":b%d", i + 1) - 1;
+      bound[i] = 1; c = 0; ++r; continue;
+    }
+
+    /* Otherwise, the value is substituted directly, and it must be safe to do so. */
+    if (!c && (!strlen(p) || strspn(p, STR_IDENTIFIER) < strlen(p))) { free(s); return STR_PARAM; }
+    d = append_value(d, p, c);
+  }
+  *d++ = '\0';
+
+  /* Declare and assign any bind variables in the commands that follow the query. */
+  for (*commands_ptr = d, *d = '\0', i = 0; i < t.param_count; ++i)
+  {
+    if (!bound[i]) continue;
+    d += sprintf(d, STR_BIND_FORMAT, i + 1, i + 1);
+    d = append_value(d, values[i], 1);
+    strcpy(d, "'\n"); d += 2;
+  }
+
+  free(s); return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine whether or not the results of a query are kept as a snapshot (see output_snapshot).  Only the results of a
+ * template query whose template specifies how long a snapshot is fresh (and that are not sampled) are; the snapshot is
+ * identified by a hash of the expanded query (along with any commands that precede it, which may assign bind variables).
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ *   id:  receives the snapshot ID (at least SNAPSHOT_ID_LENGTH + 1 bytes)
+ *   query_ptr:  receives the expanded query, followed (after its terminating null byte) by the commands that precede it, if
+ *     the results are kept as a snapshot (memory for this buffer is obtained with malloc, and should be freed with free); or
+ *     NULL (if the expanded query is not needed)
+ * Return Value:  The number of seconds for which the snapshot is fresh, or zero if the results are not kept as a snapshot.
+ */
+long find_snapshot(struct script * script_ptr, char * form, size_t length, char * id, char ** query_ptr)
+{
+  char * t, * q, * x, * w;
+  int b = !strncmp(script_ptr->commands[0], STR_SQLPLUS, strlen(STR_SQLPLUS));
+  unsigned long h;
+  long z = 0;
+
+  if (!(t = find_param(form, length, "t")) || (q = find_param(form, length, "sample")) && *q) return 0;
+  if (expand_template(script_ptr->template_path, t, form, length, b, &x, &w, &z)) z = 0;
+  else if (z)
+  {
+    /* The hash is 32 bits, so a second round (continuing from the first) extends the ID to 64 bits. */
+    h = hash_bytes(hash_bytes(HASH_BASIS, x, strlen(x)), w, strlen(w));
+    sprintf(id, "%08lx%08lx", h, hash_bytes(hash_bytes(h, x, strlen(x)), w, strlen(w)));
+    if (query_ptr) { *query_ptr = x; return z; }
+  }
+  free(x); return z;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine whether or not a snapshot is of the query requested.  (Its ID is only a hash of the query, so the form data kept
+ * with it must be the same, or must expand to the same query.)
+ *   script_ptr:  contents of script file (command lines and template path)
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ *   snapshot_ptr:  the snapshot (whose path member is overwritten)
+ * Return Value:  Nonzero if the snapshot is of the query requested; otherwise, zero.
+ */
+int match_snapshot(struct script * script_ptr, char * form, size_t length, struct snapshot * snapshot_ptr)
+{
+  char i[SNAPSHOT_ID_LENGTH + 1], * s, * x, * y;
+  size_t m;
+  int r = 0;
+
+  if (!(s = snapshot_read(snapshot_ptr, &m))) return 0;
+  if (m == length && !memcmp(s, form, m)) r = 1;
+  else if (find_snapshot(script_ptr, s, m, i, &x))
+  {
+    if (find_snapshot(script_ptr, form, length, i, &y))
+    {
+      r = !strcmp(x, y) && !strcmp(x + strlen(x) + 1, y + strlen(y) + 1);
+      free(y);
+    }
+    free(x);
+  }
+  free(s); return r;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Find a query template (by title) in the contents of a query template (JSON) file, which should be an array of objects,
+ * each with a title (string), a format (string), and parameters (array of strings).  Strings are decoded in place.
+ *   json:  contents of query template file
+ *   title:  title of query template
+ *   template_ptr:  receives query template
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * find_template(char * json, const char * title, struct template * template_ptr)
+{
+  char * p, * k;
+
+  if (*(p = json_skip(json)) != '[') return STR_TEMPLATE_FILE;
+  if (*(p = json_skip(p + 1)) == ']') return STR_TEMPLATE;
+
+  /* Parse each template (object) in the array until the one with the given title is found. */
+  for (;;)
+  {
+    if (*p != '{') return STR_TEMPLATE_FILE;
+    template_ptr->title = template_ptr->format = NULL;
+    template_ptr->param_count = 0;
+    template_ptr->snapshot = 0;
+
+    /* Parse each name/value pair in the object. */
+    if (*(p = json_skip(p + 1)) != '}') for (;;)
     {
-      case '\r': case '\n': continue;
-      case '\'': *p = '\\'; ++p;
-      default: *p = c; ++p;
+      if (!(k = json_string(&p)) || *(p = json_skip(p)) != ':') return STR_TEMPLATE_FILE;
+      p = json_skip(p + 1);
+      if (!strcmp(k, "title")) { if (!(template_ptr->title = json_string(&p))) return STR_TEMPLATE_FILE; }
+      else if (!strcmp(k, "format")) { if (!(template_ptr->format = json_string(&p))) return STR_TEMPLATE_FILE; }
+      else if (!strcmp(k, "snapshot"))
+      {
+        if (!isdigit(*p)) return STR_TEMPLATE_FILE;
+        template_ptr->snapshot = strtol(p, &p, 10);
+      }
+      else if (!strcmp(k, "params"))
+      {
+        if (*p != '[') return STR_TEMPLATE_FILE;
+        if (*(p = json_skip(p + 1)) != ']') for (;;)
+        {
+          if (template_ptr->param_count == TEMPLATE_PARAM_MAX) return STR_TEMPLATE_FILE;
+          if (!(template_ptr->params[template_ptr->param_count++] = json_string(&p))) return STR_TEMPLATE_FILE;
+          if (*(p = json_skip(p)) == ']') break;
+          if (*p != ',') return STR_TEMPLATE_FILE;
+          p = json_skip(p + 1);
+        }
+        ++p;
+      }
+      else if (!json_value(&p)) return STR_TEMPLATE_FILE;
+
+      if (*(p = json_skip(p)) == '}') break;
+      if (*p != ',') return STR_TEMPLATE_FILE;
+      p = json_skip(p + 1);
     }
-  if (ferror(f)) p = strerror(errno); else *p = '\0';
-  fclose(f); return *p ? p : NULL;
+    if (!template_ptr->title || !template_ptr->format) return STR_TEMPLATE_FILE;
+    if (!strcmp(template_ptr->title, title)) return NULL;
+
+    /* Move on to the next template (if any). */
+    if (*(p = json_skip(p + 1)) == ']') return STR_TEMPLATE;
+    if (*p != ',') return STR_TEMPLATE_FILE;
+    p = json_skip(p + 1);
+  }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Skip white space in JSON.
+ *   p:  pointer into JSON
+ * Return Value:  Pointer to the first non-white-space character.
+ */
+char * json_skip(char * p)
+{
+  while (isspace(*p)) ++p;
+  return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parse (and decode in place) a JSON string.
+ *   p_ptr:  pointer to the opening quotation mark (on return, points just past the closing quotation mark)
+ * Return Value:  On success, the decoded (null-terminated) string; otherwise, NULL.
+ */
+char * json_string(char ** p_ptr)
+{
+  char * p = *p_ptr, * s, * d;
+  long u, v;
+
+  if (*p != '"') return NULL;
+  for (s = d = ++p; *p != '"'; ++p)
+  {
+    if ((unsigned char)*p < 0x20) return NULL;
+    if (*p != '\\') { *d++ = *p; continue; }
+    switch (*++p)
+    {
+      case '"': case '\\': case '/': *d++ = *p; break;
+      case 'b': *d++ = '\b'; break;
+      case 'f': *d++ = '\f'; break;
+      case 'n': *d++ = '\n'; break;
+      case 'r': *d++ = '\r'; break;
+      case 't': *d++ = '\t'; break;
+      case 'u':
+        /* Encode the character as UTF-8 (combining a surrogate pair as needed). */
+        if ((u = json_hex(p + 1)) < 0) return NULL;
+        p += 4;
+        if (u >= 0xD800 && u < 0xDC00 && p[1] == '\\' && p[2] == 'u' && (v = json_hex(p + 3)) >= 0xDC00 && v < 0xE000)
+        { u = 0x10000 + ((u - 0xD800) << 10) + (v - 0xDC00); p += 6; }
+        if (u < 0x80) *d++ = u;
+        else if (u < 0x800) { *d++ = 0xC0 | (u >> 6); *d++ = 0x80 | (u & 0x3F); }
+        else if (u < 0x10000) { *d++ = 0xE0 | (u >> 12); *d++ = 0x80 | ((u >> 6) & 0x3F); *d++ = 0x80 | (u & 0x3F); }
+        else { *d++ = 0xF0 | (u >> 18); *d++ = 0x80 | ((u >> 12) & 0x3F); *d++ = 0x80 | ((u >> 6) & 0x3F); *d++ = 0x80 | (u & 0x3F); }
+        break;
+      default: return NULL;
+    }
+  }
+  *d = '\0'; *p_ptr = p + 1; return s;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Skip a JSON value (of any type).
+ *   p_ptr:  pointer to the beginning of the value (on return, points just past the end of it)
+ * Return Value:  Nonzero on success; otherwise, zero.
+ */
+int json_value(char ** p_ptr)
+{
+  char * p = *p_ptr;
+  int c;
+
+  if (*p == '"') return json_string(p_ptr) != NULL;
+
+  /* An object or array contains any number of values (each preceded by a name, in the case of an object). */
+  if (*p == '{' || *p == '[')
+  {
+    c = (*p == '{') ? '}' : ']';
+    if (*(p = json_skip(p + 1)) != c) for (;;)
+    {
+      if (c == '}' && (!json_string(&p) || *(p = json_skip(p)) != ':' || !*(p = json_skip(p + 1)))) return 0;
+      if (!json_value(&p)) return 0;
+      if (*(p = json_skip(p)) == c) break;
+      if (*p != ',') return 0;
+      p = json_skip(p + 1);
+    }
+    *p_ptr = p + 1; return 1;
+  }
+
+  /* Otherwise, it should be a number (or true, false, or null). */
+  while (isalnum(*p) || *p == '-' || *p == '+' || *p == '.') ++p;
+  if (p == *p_ptr) return 0;
+  *p_ptr = p; return 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Append a template parameter value to a query.
+ *   dest:  end of query (where the value is to be appended)
+ *   value:  template parameter value
+ *   literal:  nonzero if the value is within a string literal (in which case single quotes are doubled)
+ * Return Value:  New end of query.
+ */
+char * append_value(char * dest, const char * value, int literal)
+{
+  for (; *value; ++value) { if (literal && *value == '\'') *dest++ = '\''; *dest++ = *value; }
+  return dest;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
@@ -398,10 +1936,27 @@ size_t validate_query(const char * string)
   return strcasestr(string, "SELECT") ? n : 0;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the wall clock (e.g., to time the phases of executing a query).
+ * Return Value:  The current time, in seconds (with a fraction, to the precision of the system clock).
+ */
+double wall_time(void)
+{
+#ifdef _WIN32
+  struct _timeb b;
+
+  _ftime(&b); return b.time + b.millitm / 1000.0;
+#else
+  struct timeval v;
+
+  gettimeofday(&v, NULL); return v.tv_sec + v.tv_usec / 1000000.0;
+#endif
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
  * Free memory as needed, and optionally output (as HTML) an error message.
- *   string:  template path or command line
- *   query:  URL-decoded query (SQL SELECT statement)
+ *   string:  command line (and template path)
+ *   query:  request body (if any), which contains the query (SQL SELECT statement)
  *   error:  error message (if any)
  * Return Value:  Exit status (EXIT_SUCCESS or EXIT_FAILURE).
  */
@@ -410,8 +1965,12 @@ int finalize(char * string, char * query, const char * error)
   /* Free memory as needed. */
   free(string); free(query);
 
-  /* If there is an error message, output it as HTML. */
-  if (error) { output_begin(STR_ERROR); output_bridge(""); printf("<h1>%s: %s</h1>", STR_ERROR, error); output_end(); }
+  /* If there is an error message, output it as HTML.  (In this case, nothing has been output yet.) */
+  if (error)
+  {
+    output_header(STR_HTML_HEADER); output_line("<!DOCTYPE html>"); output_begin(STR_ERROR); output_bridge("");
+    output_format("<h1>%s: ", STR_ERROR); output_html(error); output_string("</h1>"); output_end();
+  }
 
   /* Return the appropriate exit status based on whether or not there is an error message. */
   return error ? EXIT_FAILURE : EXIT_SUCCESS;
@@ -15,6 +15,13 @@
 #define _HTML_H_
 
 
+/*****************
+ * Include Files *
+ *****************/
+
+#include "assets.h"  /* ASSET_URL_LEAFLET_CSS, ASSET_URL_LEAFLET_JS, ASSET_URL_MAPPING_JS */
+
+
 /*************
  * Constants *
  *************/
@@ -41,6 +48,12 @@ static const char * HTML_PROMPT_1 =
       "controls = document.forms[0].elements; "
       "for (let n = templates.length, i = 0; i < n; ++i) addTemplate(templates[i]); ";
 
+static const char * HTML_PROMPT_TEMPLATES_FORMAT =
+      "fetch('?templates=%08lx')"
+        ".then(function (r) { if (!r.ok) throw new Error(r.status + ' ' + r.statusText); return r.text(); })"
+        ".then(function (t) { if (!processTemplates(t)) showMessage('%s', 'orange'); })"
+        ".catch(function (e) { showMessage('%s: ' + e.message, 'red'); }); ";
+
 static const char * HTML_PROMPT_2 =
     "} "
     "function loadTemplates(input) "
@@ -118,9 +131,9 @@ static const char * HTML_PROMPT_3 =
     "<div></div>"
     "<button onclick='generateQuery()' disabled>Generate Query</button>"
   "</fieldset>"
-  "<form>"
+  "<form method='post'>"
     "<p>Query:<br /><textarea name='q' oninput='controls[1].disabled=!controls[0].value.length'></textarea></p>"
-    "<p><input type='submit' disabled /></p>"
+    "<p><input type='submit' disabled /> Sample: <input type='number' name='sample' min='1' max='10000' placeholder='all rows' /></p>"
   "</form>";
 
 
@@ -128,68 +141,163 @@ static const char * HTML_PROMPT_3 =
  * Macro Definitions *
  *********************/
 
-#define HTML_RESULTS \
+/* Leaflet is served by DUMPROWS (as embedded by assets/embed.sh), so that maps work without access to other sites.  Only if
+ * LEAFLET_CDN is defined (and Leaflet has not been embedded) is it loaded from unpkg.com instead.
+ */
+#if defined(ASSET_URL_LEAFLET_CSS) && defined(ASSET_URL_LEAFLET_JS)
+#  define HTML_LEAFLET_CSS ASSET_URL_LEAFLET_CSS
+#  define HTML_LEAFLET_JS ASSET_URL_LEAFLET_JS
+#elif defined(LEAFLET_CDN)
+#  define HTML_LEAFLET_CSS "https://unpkg.com/leaflet@1.7.1/dist/leaflet.css"
+#  define HTML_LEAFLET_JS "https://unpkg.com/leaflet@1.7.1/dist/leaflet.js"
+#else
+#  error "Leaflet is not embedded (regenerate assets.h with assets/embed.sh, or define LEAFLET_CDN)"
+#endif
+
+/* The results page requests the rows (as newline-delimited JSON), and renders only those that are visible.  The table is
+ * positioned within a scrolling container (sized for all rows) so that its first row is the first visible one.  Since
+ * browsers limit the height of an element (to between about 17 and 33 million pixels), the container is sized for at most
+ * ten million pixels of rows, and the scroll position is scaled to the row index beyond that.  If the rows have geometry,
+ * the map is created as soon as the first row arrives, and features are added to it in batches thereafter.
+ */
+#define HTML_RESULTS_1 \
   "<style>" \
-    "table { margin: auto; border-collapse: collapse; } " \
-    "table caption { white-space: nowrap; padding-top: 4px; } " \
-    "table, th, td { border: 1px solid; padding: 4px; } " \
-    "th { background-color: #DFDFDF; }" \
+    "#caption { overflow: hidden; white-space: nowrap; margin: 4px 0; } " \
+    "#count { float: left; margin-right: 8px; } " \
+    "#credit { float: right; font-size: smaller; } " \
+    "#credit a { font-variant: small-caps; } " \
+    "#results { position: relative; height: 80vh; overflow: auto; } " \
+    "#results table { position: absolute; top: 0; left: 0; border-collapse: collapse; table-layout: fixed; } " \
+    "th, td { border: 1px solid; padding: 0 4px; line-height: 22px; white-space: nowrap; overflow: hidden; text-overflow: ellipsis; } " \
+    "th { position: sticky; top: 0; background-color: #DFDFDF; }" \
   "</style>" \
   "<script>" \
-    "var leafletLoaded, mappingLoaded; " \
-    "function init() { var t = document.querySelector(''table''); setCaption(t); tryMapping(t); } " \
-    "function setCaption(t) " \
-    "{ var p = t.createCaption(), q, r; " \
-      "q = document.createElement(''span''); " \
-      "q.style.cssFloat = ''right''; " \
-      "q.style.fontSize = ''smaller''; " \
-      "q.style.marginLeft = ''4px''; " \
-      "q.style.marginRight = ''4px''; " \
-      "q.textContent = ''Generated by ''; " \
-      "r = document.createElement(''a''); " \
-      "r.style.fontVariant = ''small-caps''; " \
-      "r.target = ''_blank''; " \
-      "r.href = ''https://jeffbourdier.github.io/dumprows''; " \
-      "r.textContent = ''DumpRows''; " \
-      "q.appendChild(r); " \
-      "p.appendChild(q); " \
-      "q = document.createElement(''span''); " \
-      "q.style.cssFloat = ''left''; " \
-      "q.style.marginRight = ''8px''; " \
-      "r = document.body.lastElementChild; " \
-      "if (r.tagName == ''P'') " \
-      "{ q.textContent = r.textContent.trim(); r.remove(); " \
-        "r = document.body.firstElementChild; " \
-        "if (r.tagName == ''P'') r.remove(); " \
+    "var columns, rows = [], results, sizer, table, count, height = 24, maxHeight = 10000000, measured, widths, pending, " \
+      "done, failed, sampled, first = -1, last = -1, mapping, leafletLoaded, mappingLoaded; " \
+    "function init() " \
+    "{ var p = new URLSearchParams(request); " \
+      "results = document.getElementById('results'); " \
+      "sizer = results.firstChild; " \
+      "table = results.lastChild; " \
+      "count = document.getElementById('count'); " \
+      "sampled = !!p.get('sample'); " \
+      "results.onscroll = schedule; " \
+      "window.onresize = schedule; " \
+      "schedule(); " \
+      "p.set('f', 'rows'); " \
+      "fetch(location.pathname, { method: 'POST', body: p }) " \
+        ".then(function (r) " \
+        "{ if (!r.ok) throw new Error(r.status + ' ' + r.statusText); " \
+          "return receive(r.body.getReader(), new TextDecoder(), ''); " \
+        "}) " \
+        ".catch(function (e) { showError(e.message); }); " \
+    "} " \
+    "function receive(reader, decoder, text) " \
+    "{ return reader.read().then(function (r) " \
+      "{ var a, n, i; " \
+        "text += decoder.decode(r.value, { stream: !r.done }); " \
+        "a = text.split('\\n'); " \
+        "text = a.pop(); " \
+        "for (n = a.length, i = 0; i < n; ++i) if (a[i]) addRecord(JSON.parse(a[i])); " \
+        "if (!r.done) return receive(reader, decoder, text); " \
+        "if (!done) showError('The results are incomplete.'); " \
+      "}); " \
+    "} " \
+    "function addRecord(p) " \
+    "{ if (!Array.isArray(p)) { done = true; if (p.error) showError(p.error); } " \
+      "else if (!columns) setColumns(p); " \
+      "else if (rows.push(p) == 1) tryMapping(); " \
+      "schedule(); " \
+    "} " \
+    "function setColumns(c) " \
+    "{ var r = table.tHead.insertRow(), n = c.length, i, p; " \
+      "columns = c; " \
+      "for (i = 0; i < n; ++i) { p = document.createElement('th'); p.textContent = c[i]; r.appendChild(p); } " \
+    "} " \
+    "function setWidths() " \
+    "{ var p = document.createElement('colgroup'), q, n = columns.length, m = Math.min(rows.length, 100), w = 0, i, j, k; " \
+      "for (i = 0; i < n; ++i) " \
+      "{ for (k = columns[i].length, j = 0; j < m; ++j) k = Math.max(k, (rows[j][i] || '').length); " \
+        "k = Math.min(Math.max(k, 4), 40) + 2; " \
+        "q = document.createElement('col'); " \
+        "q.style.width = k + 'ch'; " \
+        "p.appendChild(q); " \
+        "w += k; " \
+      "} " \
+      "table.insertBefore(p, table.firstChild); " \
+      "table.style.width = w + 'ch'; " \
+      "widths = true; " \
+    "} " \
+    "function schedule() { if (!pending) pending = requestAnimationFrame(render); } " \
+    "function render() " \
+    "{ var b = table.tBodies[0], n = rows.length, h = table.tHead.offsetHeight, t = results.scrollTop, s, k, y, f, l, m, i, " \
+        "j, r, c; " \
+      "pending = 0; " \
+      "if (!failed) count.textContent = n.toLocaleString() + (sampled ? ' rows (random sample)' : ' rows') + (done ? '' : ' (loading)'); " \
+      "if (!columns) return; " \
+      "if (mapping && addFeatures(mapping, done)) schedule(); " \
+      "if (!widths && (n >= 100 || done)) setWidths(); " \
+      "s = Math.min(n * height, maxHeight); " \
+      "k = (n * height > s) ? (n * height + h - results.clientHeight) / (s + h - results.clientHeight) : 1; " \
+      "y = t * k; " \
+      "f = Math.min(Math.floor(y / height), n); " \
+      "l = Math.min(f + Math.ceil(results.clientHeight / height) + 1, n); " \
+      "sizer.style.height = (h + s) + 'px'; " \
+      "table.style.top = (t - y + f * height) + 'px'; " \
+      "if (f == first && l == last) return; " \
+      "for (m = columns.length, i = f; i < l; ++i) " \
+      "{ r = b.rows[i - f] || b.insertRow(); " \
+        "for (j = 0; j < m; ++j) { c = r.cells[j] || r.insertCell(); c.textContent = rows[i][j] || ''; } " \
       "} " \
-      "else q.textContent = (t.rows.length - 1) + '' rows''; " \
-      "p.appendChild(q); " \
+      "while (b.rows.length > l - f) b.deleteRow(-1); " \
+      "first = f; " \
+      "last = l; " \
+      "if (!measured && l > f) { measured = true; height = b.offsetHeight / (l - f); first = -1; schedule(); } " \
     "} " \
-    "function tryMapping(t) " \
-    "{ for (var p, k, g = -1, c = t.rows[1].cells, n = c.length, i = 0; i < n; ++i) " \
-      "{ try { p = JSON.parse(c[i].textContent); } catch { continue; } " \
-        "if ((k = Object.keys(p)).length != 2 || k[0] != ''type'' || k[1] != ''coordinates'' " \
-          "|| (p.type != ''Point'' && p.type != ''LineString'' && p.type != ''Polygon'' && p.type != ''MultiPolygon'') " \
+    "function showError(text) { failed = true; count.textContent = text; count.style.color = 'red'; } " \
+    "function tryMapping() " \
+    "{ for (var p, k, g = -1, c = rows[0], n = c.length, i = 0; i < n; ++i) " \
+      "{ try { p = JSON.parse(c[i]); } catch { continue; } " \
+        "if (!p || (k = Object.keys(p)).length != 2 || k[0] != 'type' || k[1] != 'coordinates' " \
+          "|| (p.type != 'Point' && p.type != 'LineString' && p.type != 'Polygon' && p.type != 'MultiPolygon') " \
           "|| !Array.isArray(p.coordinates)) continue; " \
         "if (g > 0) return; " \
         "g = i; " \
       "} " \
       "if (g < 0) return; " \
-      "p = document.createElement(''link''); " \
-      "p.rel = ''stylesheet''; " \
-      "p.type = ''text/css''; " \
-      "p.href = ''https://unpkg.com/leaflet@1.7.1/dist/leaflet.css''; " \
-      "document.head.insertBefore(p, document.head.lastChild); " \
-      "p = document.createElement(''script''); " \
-      "p.src = ''https://unpkg.com/leaflet@1.7.1/dist/leaflet.js''; " \
-      "p.onload = function () { leafletLoaded = true; if (mappingLoaded) initMapping(t, g); }; " \
-      "document.head.insertBefore(p, document.head.lastChild); " \
-      "p = document.createElement(''script''); " \
-      "p.src = ''https://jeffbourdier.github.io/dumprows/mapping.js''; " \
-      "document.head.insertBefore(p, document.head.lastChild); " \
-      "p.onload = function () { mappingLoaded = true; if (leafletLoaded) initMapping(t, g); }; " \
-    "}" \
+      "p = document.createElement('link'); " \
+      "p.rel = 'stylesheet'; " \
+      "p.type = 'text/css'; " \
+      "p.href = '" HTML_LEAFLET_CSS "'; " \
+      "document.head.appendChild(p); " \
+      "p = document.createElement('script'); " \
+      "p.src = '" HTML_LEAFLET_JS "'; " \
+      "p.onload = function () { leafletLoaded = true; if (mappingLoaded) startMapping(g); }; " \
+      "document.head.appendChild(p); " \
+      "p = document.createElement('script'); " \
+      "p.src = '" ASSET_URL_MAPPING_JS "'; " \
+      "p.onload = function () { mappingLoaded = true; if (leafletLoaded) startMapping(g); }; " \
+      "document.head.appendChild(p); " \
+    "} " \
+    "function startMapping(g) { mapping = initMapping(results, columns, rows, g); schedule(); }" \
   "</script>"
 
+#define HTML_RESULTS_2 \
+  "<p id='caption'>" \
+    "<span id='count'></span>" \
+    "<span id='credit'>Generated by <a target='_blank' href='https://jeffbourdier.github.io/dumprows'>DumpRows</a></span>" \
+  "</p>" \
+  "<div id='results'><div></div><table><thead></thead><tbody></tbody></table></div>"
+
+/* The profile page shows the query, its plan (one table row per record output by the database utility), and the timings. */
+#define HTML_PROFILE \
+  "<style>" \
+    "table { border-collapse: collapse; margin-bottom: 1em; } " \
+    "th, td { border: 1px solid; padding: 0 4px; text-align: left; vertical-align: top; } " \
+    "th { background-color: #DFDFDF; } " \
+    "td, pre { font-family: monospace; white-space: pre-wrap; } " \
+    "td.n { text-align: right; }" \
+  "</style>"
+
 
 #endif  /* (prevent multiple inclusion) */
@@ -0,0 +1,449 @@
+/* job.c - Asynchronous (export) jobs for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <sys/stat.h>      /* lstat, mkdir, stat, (struct) stat, S_IRUSR, S_ISDIR, S_IRWXU, S_IWGRP, S_IWOTH, S_IWUSR,
+                              _S_IREAD, _S_IWRITE */
+#include <errno.h>         /* EEXIST, ENAMETOOLONG, errno */
+#include <fcntl.h>         /* fcntl, (struct) flock, F_SETLK, F_WRLCK, open, O_CREAT, O_RDWR, _O_CREAT, _O_RDWR */
+#ifdef _WIN32
+#  include <direct.h>      /* _mkdir */
+#  include <io.h>          /* _close, _findclose, _findfirst, (struct) _finddata_t, _findnext, _locking, _open, intptr_t */
+#  include <process.h>     /* _getpid, _P_DETACH, _spawnv */
+#  include <sys/locking.h> /* _LK_NBLCK */
+#  include <windows.h>     /* Sleep */
+#else
+#  include <dirent.h>      /* closedir, (struct) dirent, opendir, readdir, DIR */
+#  include <unistd.h>      /* close, dup2, execv, fork, geteuid, getpid, setsid, sleep, _exit */
+#endif
+#include <stdio.h>         /* remove, rename, SEEK_SET, snprintf, sprintf */
+#include <stdlib.h>        /* free, getenv, malloc, rand, srand */
+#include <string.h>        /* memset, strchr, strcmp, strcpy, strerror, strlen, strspn */
+#include <time.h>          /* time, time_t */
+#include "jb.h"            /* jb_file_read, jb_file_write, JB_PATH_MAX_LENGTH */
+#include "job.h"           /* (struct) job, JOB_FORM, JOB_ID_LENGTH, JOB_MAX, JOB_OUTPUT, JOB_RETENTION, JOB_STATUS,
+                              JOB_WORKERS */
+
+
+/*************
+ * Constants *
+ *************/
+
+static const char * STR_DIRECTORY = "Temporary directory is not private to this user";
+static const char * STR_JOB_ID = "Job ID is not valid";
+static const char * STR_JOB_LIMIT = "Too many jobs (try again later)";
+static const char * STR_QUEUED = "queued";
+static const char * STR_TEMPORARY = ".tmp";
+static const char * STR_HEX = "0123456789abcdef";
+static const char * STR_DIRECTORY_FORMAT = "%s/dumprows%08lx.jobs";
+static const char * STR_PATH_FORMAT = "%s/%s%s";
+static const char * STR_FILE_FORMAT = "%s/%.*s%s";
+static const char * STR_SLOT_FORMAT = "%s/slot%d.lock";
+static const char * STR_ID_FORMAT = "%08lx%08lx";
+static const char * STR_OPTION_FORMAT = "--job=%s";
+static const char * STR_STATUS_FORMAT = "%s\n%s\n%s\n";
+static const char * STR_FILES[] = { JOB_OUTPUT, JOB_FORM, JOB_STATUS, NULL };
+
+
+/*********************************
+ * Private Function Declarations *
+ *********************************/
+
+int keep_files(const char * directory, const char * name, time_t age, const char * extension, size_t length, long retention,
+  const char * extensions[]);
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Create a job (which is queued until a worker executes it).  Any jobs that have expired are removed first, and if too
+ * many remain, the job is not created.
+ *   job:  receives the job
+ *   key:  identifies the script file (e.g., a hash of its path), whose jobs are kept together
+ *   form:  decoded form data of the request (which the worker uses to execute the query)
+ *   length:  length of decoded form data
+ *   format:  format of the results (e.g., "csv")
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_create(struct job * job, unsigned long key, const char * form, size_t length, const char * format)
+{
+  struct stat st;
+  unsigned long n;
+  int i;
+  const char * p;
+
+  if ((p = job_open(job, key, NULL))) return p;
+  if (job_expire(job->directory, JOB_STATUS, JOB_ID_LENGTH, JOB_RETENTION, STR_FILES) >= JOB_MAX) return STR_JOB_LIMIT;
+
+  /* The ID comprises the time and a random number (chosen again in the unlikely event that it is already in use). */
+#ifdef _WIN32
+  srand((unsigned int)time(NULL) ^ (unsigned int)_getpid());
+#else
+  srand((unsigned int)time(NULL) ^ (unsigned int)getpid());
+#endif
+  for (i = 0; i < 0x10; ++i)
+  {
+    n = ((unsigned long)rand() << 16 ^ (unsigned long)rand()) & 0xFFFFFFFFUL;
+    sprintf(job->id, STR_ID_FORMAT, (unsigned long)time(NULL) & 0xFFFFFFFFUL, n);
+    if (!job_path(job, JOB_STATUS)) return strerror(ENAMETOOLONG);
+    if (stat(job->path, &st)) break;
+  }
+
+  /* Keep the form data, and note that the job is queued. */
+  if (jb_file_write(job_path(job, JOB_FORM), form, length)) return strerror(errno);
+  return job_status(job, STR_QUEUED, format, "");
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Identify an existing job (whose files may or may not exist).
+ *   job:  receives the job
+ *   key:  identifies the script file (see job_create)
+ *   id:  job ID (or NULL, in which case the job has no ID yet)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_open(struct job * job, unsigned long key, const char * id)
+{
+  memset(job, 0, sizeof(struct job));
+  job->slot = -1;
+
+  if (id)
+  {
+    if (!job_valid(id, JOB_ID_LENGTH)) return STR_JOB_ID;
+    strcpy(job->id, id);
+  }
+  return job_directory(job->directory, STR_DIRECTORY_FORMAT, key);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compose the path of one of the files that make up a job.
+ *   job:  job (whose path member receives the path)
+ *   extension:  JOB_FORM, JOB_OUTPUT, or JOB_STATUS
+ * Return Value:  The path, or NULL if it is too long.
+ */
+const char * job_path(struct job * job, const char * extension)
+{
+  return (snprintf(job->path, JB_PATH_MAX_LENGTH, STR_PATH_FORMAT, job->directory, job->id, extension) < JB_PATH_MAX_LENGTH)
+    ? job->path : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Spawn a worker (this program, with the --job option) to execute a job, detached from this process (so that neither the
+ * web server nor the client waits for it).
+ *   job:  job
+ *   argv:  array of command line arguments (same as argv passed to main)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_spawn(struct job * job, char * argv[])
+{
+  char s[JOB_ID_LENGTH + 8];
+
+  sprintf(s, STR_OPTION_FORMAT, job->id);
+  return job_detach(argv, s);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Wait for a worker slot (i.e., until fewer than JOB_WORKERS jobs are executing).  A slot is a locked file, which is
+ * unlocked when the job is released (or if the worker exits for any reason).
+ *   job:  job (whose slot member receives the descriptor of the slot file)
+ */
+void job_wait(struct job * job)
+{
+  char s[JB_PATH_MAX_LENGTH];
+  int i;
+
+  for (;;)
+  {
+    for (i = 0; i < JOB_WORKERS; ++i)
+    {
+      if (snprintf(s, JB_PATH_MAX_LENGTH, STR_SLOT_FORMAT, job->directory, i) >= JB_PATH_MAX_LENGTH) return;
+      if ((job->slot = job_lock(s)) >= 0) return;
+    }
+#ifdef _WIN32
+    Sleep(1000);
+#else
+    sleep(1);
+#endif
+  }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Note the status of a job.  The status file is replaced (rather than rewritten), so that it is never read partially.
+ *   job:  job
+ *   state:  "queued", "running", "done", or "failed"
+ *   format:  format of the results
+ *   outcome:  number of rows (if done), error message (if failed), or empty
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_status(struct job * job, const char * state, const char * format, const char * outcome)
+{
+  char s[JB_PATH_MAX_LENGTH], * p;
+  int n;
+
+  if (!(p = malloc(strlen(state) + strlen(format) + strlen(outcome) + 4))) return strerror(errno);
+  n = sprintf(p, STR_STATUS_FORMAT, state, format, outcome);
+  if (!job_path(job, JOB_STATUS) || snprintf(s, JB_PATH_MAX_LENGTH, "%s%s", job->path, STR_TEMPORARY) >= JB_PATH_MAX_LENGTH)
+  {
+    free(p); return strerror(ENAMETOOLONG);
+  }
+  n = jb_file_write(s, p, n); free(p);
+  return n ? strerror(errno) : job_replace(s, job->path);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read one of the files that make up a job.
+ *   job:  job
+ *   extension:  JOB_FORM or JOB_STATUS
+ *   size_ptr:  receives the size of the file (or NULL)
+ * Return Value:  The contents of the file (null-terminated, which should be freed with free), or NULL if it does not exist.
+ */
+char * job_read(struct job * job, const char * extension, size_t * size_ptr)
+{
+  struct stat st;
+  char * p;
+
+  if (!job_path(job, extension) || stat(job->path, &st) || !(p = jb_file_read(job->path, st.st_size))) return NULL;
+  p[st.st_size] = '\0';
+  if (size_ptr) *size_ptr = st.st_size;
+  return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the status of a job (see job_status).
+ *   job:  job
+ *   format_ptr:  receives the format of the results
+ *   outcome_ptr:  receives the outcome (which may span lines, e.g., an error message)
+ * Return Value:  The state (in a buffer that also contains the format and outcome, which should be freed with free), or NULL
+ *   if the job does not exist.
+ */
+char * job_state(struct job * job, char ** format_ptr, char ** outcome_ptr)
+{
+  char * s, * p;
+  size_t n;
+
+  if (!(s = job_read(job, JOB_STATUS, &n))) return NULL;
+  if (n && s[n - 1] == '\n') s[--n] = '\0';
+  *format_ptr = *outcome_ptr = s + n;
+  if (p = strchr(s, '\n')) { *p = '\0'; *format_ptr = ++p; if (p = strchr(p, '\n')) { *p = '\0'; *outcome_ptr = ++p; } }
+  return s;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Release the worker slot of a job (see job_wait).
+ *   job:  job
+ */
+void job_release(struct job * job)
+{
+  job_unlock(job->slot); job->slot = -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compose the path of a directory (e.g., of jobs, or of snapshots) in the temporary directory, and create the directory
+ * (accessible only to this user) if it does not exist.  Since the path is predictable, a directory that exists already must
+ * belong to this user, and must not be writable by anyone else (who could otherwise plant files in it, e.g. results).
+ *   directory:  buffer (of JB_PATH_MAX_LENGTH bytes) to receive the path
+ *   format:  format of the path (given the path of the temporary directory, and the key)
+ *   key:  identifies the script file (see job_create)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_directory(char * directory, const char * format, unsigned long key)
+{
+  const char * p;
+#ifndef _WIN32
+  struct stat s;
+#endif
+
+#ifdef _WIN32
+  if (!(p = getenv("TMP")) && !(p = getenv("TEMP"))) p = ".";
+#else
+  if (!(p = getenv("TMPDIR")) || !*p) p = "/tmp";
+#endif
+  if (snprintf(directory, JB_PATH_MAX_LENGTH, format, p, key) >= JB_PATH_MAX_LENGTH) return strerror(ENAMETOOLONG);
+#ifdef _WIN32
+  if (_mkdir(directory) && errno != EEXIST) return strerror(errno);
+#else
+  if (mkdir(directory, S_IRWXU) && errno != EEXIST) return strerror(errno);
+  if (lstat(directory, &s)) return strerror(errno);
+  if (!S_ISDIR(s.st_mode) || s.st_uid != geteuid() || (s.st_mode & (S_IWGRP | S_IWOTH))) return STR_DIRECTORY;
+#endif
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Validate an ID (e.g., of a job, or of a snapshot), which must comprise only lowercase hexadecimal digits (so that it
+ * cannot refer to any file other than those named for it).
+ *   id:  ID
+ *   length:  length that the ID must have
+ * Return Value:  Nonzero if the ID is valid; otherwise, zero.
+ */
+int job_valid(const char * id, size_t length)
+{
+  return strlen(id) == length && strspn(id, STR_HEX) == length;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Spawn a process (this program, with an option, e.g. --job) detached from this process (so that neither the web server
+ * nor the client waits for it).
+ *   argv:  array of command line arguments (same as argv passed to main)
+ *   option:  option (including its argument) that precedes the script file
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_detach(char * argv[], const char * option)
+{
+  const char * a[4];
+#ifndef _WIN32
+  int d;
+#endif
+
+  a[0] = argv[0]; a[1] = option; a[2] = argv[1]; a[3] = NULL;
+
+#ifdef _WIN32
+  return (_spawnv(_P_DETACH, argv[0], a) < 0) ? strerror(errno) : NULL;
+#else
+  /* The child starts a new session, and its standard streams are redirected (so that the pipes to the web server close). */
+  if ((d = fork()) < 0) return strerror(errno);
+  if (d) return NULL;
+  setsid();
+  if ((d = open("/dev/null", O_RDWR)) >= 0) { dup2(d, 0); dup2(d, 1); dup2(d, 2); if (d > 2) close(d); }
+  execv(argv[0], (char * const *)a);
+  _exit(127);
+#endif
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Lock a file (without waiting), e.g. a worker slot.  The file is unlocked by job_unlock (or if the process exits for any
+ * reason).
+ *   path:  path of file (which is created if it does not exist)
+ * Return Value:  Descriptor of the (locked) file on success; otherwise (e.g., if another process holds the lock), -1.
+ */
+int job_lock(const char * path)
+{
+  int d;
+#ifdef _WIN32
+  if ((d = _open(path, _O_RDWR | _O_CREAT, _S_IREAD | _S_IWRITE)) < 0) return -1;
+  if (!_locking(d, _LK_NBLCK, 1)) return d;
+  _close(d);
+#else
+  struct flock k;
+
+  if ((d = open(path, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR)) < 0) return -1;
+  memset(&k, 0, sizeof(struct flock));
+  k.l_type = F_WRLCK; k.l_whence = SEEK_SET;
+  if (!fcntl(d, F_SETLK, &k)) return d;
+  close(d);
+#endif
+  return -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Unlock a file (see job_lock).
+ *   descriptor:  descriptor of the locked file (or -1, in which case nothing is done)
+ */
+void job_unlock(int descriptor)
+{
+#ifdef _WIN32
+  if (descriptor >= 0) _close(descriptor);
+#else
+  if (descriptor >= 0) close(descriptor);
+#endif
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Replace a file with a temporary file (which was written in full), so that the file is never read partially.
+ *   temporary:  path of temporary file
+ *   path:  path of file to replace (which need not exist)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * job_replace(const char * temporary, const char * path)
+{
+#ifdef _WIN32
+  /* On Win32, rename fails if the new file exists. */
+  remove(path);
+#endif
+  return rename(temporary, path) ? strerror(errno) : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Remove every set of files in a directory that has expired, i.e., whose identifying file has not changed for a given number of
+ * seconds (as jobs and snapshots are removed).
+ *   directory:  path of the directory
+ *   extension:  extension of the file that identifies a set (and is named for its ID)
+ *   length:  length of an ID
+ *   retention:  number of seconds for which a set is kept
+ *   extensions:  extensions of the files in a set (terminated by a null pointer), that of the identifying file last
+ * Return Value:  The number of sets that remain.
+ */
+int job_expire(const char * directory, const char * extension, size_t length, long retention, const char * extensions[])
+{
+  char s[JB_PATH_MAX_LENGTH];
+  time_t t = time(NULL);
+  int c = 0;
+#ifdef _WIN32
+  struct _finddata_t f;
+  intptr_t d;
+
+  if (snprintf(s, JB_PATH_MAX_LENGTH, "%s/*%s", directory, extension) >= JB_PATH_MAX_LENGTH) return 0;
+  if ((d = _findfirst(s, &f)) < 0) return 0;
+  do c += keep_files(directory, f.name, t - f.time_write, extension, length, retention, extensions); while (!_findnext(d, &f));
+  _findclose(d);
+#else
+  struct dirent * e;
+  struct stat st;
+  DIR * d;
+
+  if (!(d = opendir(directory))) return 0;
+  while (e = readdir(d))
+  {
+    if (snprintf(s, JB_PATH_MAX_LENGTH, "%s/%s", directory, e->d_name) >= JB_PATH_MAX_LENGTH) continue;
+    if (!stat(s, &st)) c += keep_files(directory, e->d_name, t - st.st_mtime, extension, length, retention, extensions);
+  }
+  closedir(d);
+#endif
+  return c;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Keep or remove a set of files (see job_expire).
+ *   directory:  path of the directory
+ *   name:  name of a file in the directory
+ *   age:  number of seconds since the file was modified
+ *   extension, length, retention, extensions:  (see job_expire)
+ * Return Value:  1 if the file identifies a set that is kept; otherwise, 0.
+ */
+int keep_files(const char * directory, const char * name, time_t age, const char * extension, size_t length, long retention,
+  const char * extensions[])
+{
+  char s[JB_PATH_MAX_LENGTH];
+  int i;
+
+  if (strlen(name) != length + strlen(extension) || strcmp(name + length, extension)) return 0;
+  if (age <= retention) return 1;
+
+  /* The files of an expired set are removed (the identifying file last, since it identifies the set). */
+  for (i = 0; extensions[i]; ++i)
+  {
+    if (snprintf(s, JB_PATH_MAX_LENGTH, STR_FILE_FORMAT, directory, (int)length, name, extensions[i]) < JB_PATH_MAX_LENGTH)
+      remove(s);
+  }
+  return 0;
+}
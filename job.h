@@ -0,0 +1,75 @@
+/* job.h - Asynchronous (export) jobs for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _JOB_H_
+#define _JOB_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include <stddef.h>  /* size_t */
+#include "jb.h"      /* JB_PATH_MAX_LENGTH */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define JOB_ID_LENGTH 0x10  /* 16 */
+#define JOB_WORKERS 2  /* maximum number of jobs executed at once (any others wait) */
+#define JOB_MAX 0x20  /* 32 (maximum number of jobs kept at once, whether waiting, executing, or finished) */
+#define JOB_RETENTION 86400  /* number of seconds that a job is kept (one day) */
+
+/* Files that make up a job (named for the job, with these extensions) */
+#define JOB_FORM ".form"  /* form data of the request that created the job */
+#define JOB_STATUS ".status"  /* state, format, and outcome (row count or error message), each on its own line */
+#define JOB_OUTPUT ".out"  /* results */
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* A job, which is kept (as files named for its ID) in a directory named for the script file. */
+struct job
+{
+  char id[JOB_ID_LENGTH + 1], directory[JB_PATH_MAX_LENGTH], path[JB_PATH_MAX_LENGTH];
+  int slot;
+};
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+const char * job_create(struct job * job, unsigned long key, const char * form, size_t length, const char * format);
+const char * job_open(struct job * job, unsigned long key, const char * id);
+const char * job_path(struct job * job, const char * extension);
+const char * job_spawn(struct job * job, char * argv[]);
+void job_wait(struct job * job);
+const char * job_status(struct job * job, const char * state, const char * format, const char * outcome);
+char * job_read(struct job * job, const char * extension, size_t * size_ptr);
+char * job_state(struct job * job, char ** format_ptr, char ** outcome_ptr);
+void job_release(struct job * job);
+const char * job_directory(char * directory, const char * format, unsigned long key);
+int job_valid(const char * id, size_t length);
+const char * job_detach(char * argv[], const char * option);
+int job_lock(const char * path);
+void job_unlock(int descriptor);
+const char * job_replace(const char * temporary, const char * path);
+int job_expire(const char * directory, const char * extension, size_t length, long retention, const char * extensions[]);
+
+
+#endif  /* (prevent multiple inclusion) */
@@ -0,0 +1,386 @@
+/* output.c - Buffered output (with escaping) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <sys/stat.h>      /* S_IRUSR, S_IWUSR, _S_IREAD, _S_IWRITE */
+#include <errno.h>         /* EINTR, errno */
+#include <fcntl.h>         /* open, O_CREAT, O_TRUNC, O_WRONLY, _O_BINARY, _O_CREAT, _O_TRUNC, _O_WRONLY */
+#ifdef _WIN32
+#  include <io.h>          /* _close, _open, _write */
+#else
+#  include <sys/uio.h>     /* (struct) iovec, writev */
+#  include <unistd.h>      /* close */
+#endif
+#include <stdarg.h>        /* va_end, va_list, va_start */
+#include <stdio.h>         /* vsnprintf */
+#include <stdlib.h>        /* atexit, free, malloc */
+#include <string.h>        /* memcpy, strerror, strlen */
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86_FP) && _M_IX86_FP >= 2
+#  include <emmintrin.h>   /* _mm_cmpeq_epi8, _mm_loadu_si128, _mm_max_epu8, _mm_movemask_epi8, _mm_or_si128, _mm_set1_epi8,
+                              _mm_setzero_si128, __m128i */
+#  define OUTPUT_SSE2
+#endif
+#include "output.h"        /* OUTPUT_BUFFER_SIZE */
+
+
+/*************
+ * Constants *
+ *************/
+
+/* Characters that must be escaped (in addition to control characters, for JSON) */
+static const char * STR_JSON_SPECIAL = "\"\\<";
+static const char * STR_HTML_SPECIAL = "&<>\"'";
+static const char * STR_CSV_SPECIAL = ",\"\r\n";
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define OUTPUT_SPECIAL_MAX 5  /* maximum number of characters that find_special can find (besides control characters) */
+
+/* These are used to scan a word (eight bytes) at a time for the characters of interest (as in url_decode). */
+#define WORD_ONES 0x0101010101010101ULL
+#define WORD_HIGHS 0x8080808080808080ULL
+#define word_below(w, c) (((w) - WORD_ONES * (c)) & ~(w) & WORD_HIGHS)
+#define word_has(w, c) word_below((w) ^ (WORD_ONES * (unsigned char)(c)), 1)
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* The state of the output:  the buffer (and how much of it is filled), the number of bytes written from it (since output
+ * was last redirected), the descriptor to which it is written (standard output, unless output_open is called), and whether
+ * or not the buffer is flushed at exit.
+ */
+static struct
+{
+  char buffer[OUTPUT_BUFFER_SIZE];
+  size_t length, written;
+  int descriptor, registered;
+} output = { "", 0, 0, 1, 0 };
+
+
+/*********************************
+ * Private Function Declarations *
+ *********************************/
+
+size_t find_special(const char * string, size_t length, const char * special, int control);
+int write_all(const char * buffer, size_t size, const char * more, size_t more_size);
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Redirect output to a file (instead of standard output), which is created (or truncated).  Anything output so far is
+ * flushed first.
+ *   path:  file pathname
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_open(const char * path)
+{
+  int d;
+
+  output_flush();
+#ifdef _WIN32
+  d = _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  d = open(path, O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+#endif
+  if (d < 0) return strerror(errno);
+  output.descriptor = d; output.written = 0; return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Flush output, and close the file to which it is redirected (see output_open).  Output reverts to standard output.
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * output_close(void)
+{
+  int n = write_all(output.buffer, output.length, NULL, 0);
+
+  output.length = 0;
+#ifdef _WIN32
+  if (_close(output.descriptor)) n = -1;
+#else
+  if (close(output.descriptor)) n = -1;
+#endif
+  output.descriptor = 1;
+  return n ? strerror(errno) : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Count the bytes output (e.g., to profile a query).
+ * Return Value:  The number of bytes output (whether written or still buffered) since output was last redirected by
+ *                output_open, or since the program started if it has not been.
+ */
+size_t output_count(void)
+{
+  return output.written + output.length;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Write whatever is buffered (e.g., before waiting for more output from a database utility, so that the client gets what
+ * there is so far).
+ */
+void output_flush(void)
+{
+  if (output.length) write_all(output.buffer, output.length, NULL, 0);
+  output.length = 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output bytes.  They are copied into the buffer (which is flushed whenever it fills), unless there are too many, in which
+ * case they are written along with whatever is buffered (by one system call, without copying).
+ *   buffer:  bytes to output
+ *   size:  number of bytes to output
+ */
+void output_write(const void * buffer, size_t size)
+{
+  const char * p = buffer;
+  size_t n = OUTPUT_BUFFER_SIZE - output.length;
+
+  /* The buffer is flushed at exit (however main returns). */
+  if (!output.registered) output.registered = !atexit(output_flush);
+
+  if (size <= n) { memcpy(output.buffer + output.length, p, size); output.length += size; return; }
+  if (size < OUTPUT_BUFFER_SIZE)
+  {
+    memcpy(output.buffer + output.length, p, n); output.length = OUTPUT_BUFFER_SIZE; output_flush();
+    memcpy(output.buffer, p + n, output.length = size - n); return;
+  }
+  write_all(output.buffer, output.length, p, size);
+  output.length = 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a string (like fputs).
+ *   string:  string to output
+ */
+void output_string(const char * string)
+{
+  output_write(string, strlen(string));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a string followed by a newline (like puts).
+ *   string:  string to output
+ */
+void output_line(const char * string)
+{
+  output_write(string, strlen(string)); output_char('\n');
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a character (like putchar).
+ *   c:  character to output
+ */
+void output_char(int c)
+{
+  if (output.length == OUTPUT_BUFFER_SIZE) output_flush();
+  output.buffer[output.length++] = (char)c;
+  if (!output.registered) output.registered = !atexit(output_flush);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output formatted data (like printf), directly into the buffer if it fits.
+ *   format:  format string (as for printf)
+ */
+void output_format(const char * format, ...)
+{
+  va_list a;
+  char * p;
+  int n;
+
+  va_start(a, format);
+  n = vsnprintf(output.buffer + output.length, OUTPUT_BUFFER_SIZE - output.length, format, a);
+  va_end(a);
+  if (n < 0) return;
+  if ((size_t)n < OUTPUT_BUFFER_SIZE - output.length)
+  {
+    output.length += n;
+    if (!output.registered) output.registered = !atexit(output_flush);
+    return;
+  }
+
+  /* If the data did not fit, it is formatted again, either after the buffer is flushed, or (if it is too big) in memory of
+   * its own.
+   */
+  output_flush();
+  va_start(a, format);
+  if (n < OUTPUT_BUFFER_SIZE) output.length = vsnprintf(output.buffer, OUTPUT_BUFFER_SIZE, format, a);
+  else if (p = malloc(n + 1)) { vsnprintf(p, n + 1, format, a); output_write(p, n); free(p); }
+  va_end(a);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a string as a JSON string literal.  Less-than signs are escaped too, so that the
+ * literal can be embedded safely in a <script> element (i.e., it cannot end the element).
+ *   string:  string to output
+ */
+void output_json(const char * string)
+{
+  size_t n = strlen(string), i;
+
+  output_char('"');
+  for (;;)
+  {
+    /* Output each run of characters that need not be escaped all at once. */
+    output_write(string, i = find_special(string, n, STR_JSON_SPECIAL, 1));
+    if (i == n) break;
+    switch (string[i])
+    {
+      case '"': output_write("\\\"", 2); break;
+      case '\\': output_write("\\\\", 2); break;
+      case '\n': output_write("\\n", 2); break;
+      case '\r': output_write("\\r", 2); break;
+      case '\t': output_write("\\t", 2); break;
+      default: output_format("\\u%04x", (unsigned char)string[i]);
+    }
+    string += ++i; n -= i;
+  }
+  output_char('"');
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a string as HTML text (or an attribute value), with the characters that are special in HTML escaped.
+ *   string:  string to output
+ */
+void output_html(const char * string)
+{
+  size_t n = strlen(string), i;
+
+  for (;;)
+  {
+    output_write(string, i = find_special(string, n, STR_HTML_SPECIAL, 0));
+    if (i == n) break;
+    switch (string[i])
+    {
+      case '&': output_write("&amp;", 5); break;
+      case '<': output_write("&lt;", 4); break;
+      case '>': output_write("&gt;", 4); break;
+      case '"': output_write("&quot;", 6); break;
+      default: output_write("&#39;", 5);
+    }
+    string += ++i; n -= i;
+  }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Output a string as a CSV field.  A field that contains a comma, double quote, or line break is enclosed in double quotes
+ * (with any double quotes doubled).
+ *   string:  string to output
+ */
+void output_csv_value(const char * string)
+{
+  size_t n = strlen(string), i;
+
+  if ((i = find_special(string, n, STR_CSV_SPECIAL, 0)) == n) { output_write(string, n); return; }
+  output_char('"');
+  for (;;)
+  {
+    output_write(string, i = find_special(string, n, "\"", 0));
+    if (i == n) break;
+    output_write("\"\"", 2);
+    string += ++i; n -= i;
+  }
+  output_char('"');
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Find the first character of a string that must be escaped.  Most strings contain none, so the string is scanned sixteen
+ * bytes at a time (with SSE2), or else eight bytes at a time (a word at a time), until one is found.
+ *   string:  string to scan
+ *   length:  length of string
+ *   special:  characters that must be escaped (no more than OUTPUT_SPECIAL_MAX)
+ *   control:  nonzero if control characters (i.e., below 0x20) must be escaped too
+ * Return Value:  Index of the first character that must be escaped, or the length of the string if there is none.
+ */
+size_t find_special(const char * string, size_t length, const char * special, int control)
+{
+  size_t i = 0, k = strlen(special), j;
+  unsigned long long w, m;
+#ifdef OUTPUT_SSE2
+  __m128i s[OUTPUT_SPECIAL_MAX], t = _mm_set1_epi8(0x1F), v, r;
+
+  for (j = 0; j < k; ++j) s[j] = _mm_set1_epi8(special[j]);
+  for (; i + 16 <= length; i += 16)
+  {
+    v = _mm_loadu_si128((const __m128i *)(string + i));
+    r = control ? _mm_cmpeq_epi8(_mm_max_epu8(v, t), t) : _mm_setzero_si128();
+    for (j = 0; j < k; ++j) r = _mm_or_si128(r, _mm_cmpeq_epi8(v, s[j]));
+    if (_mm_movemask_epi8(r)) break;
+  }
+#endif
+
+  for (; i + 8 <= length; i += 8)
+  {
+    memcpy(&w, string + i, 8);
+    for (m = control ? word_below(w, 0x20) : 0, j = 0; j < k; ++j) m |= word_has(w, special[j]);
+    if (m) break;
+  }
+
+  /* Find the character itself (within the block that contains it, if any). */
+  for (; i < length; ++i)
+  {
+    if (control && (unsigned char)string[i] < 0x20) break;
+    for (j = 0; j < k; ++j) if (string[i] == special[j]) return i;
+  }
+  return i;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Write two blocks of bytes to the output descriptor (in a single system call where possible), until all are written.
+ *   buffer:  first block
+ *   size:  size of first block
+ *   more:  second block (or NULL)
+ *   more_size:  size of second block
+ * Return Value:  Zero on success; otherwise, nonzero (and errno is set appropriately).
+ */
+int write_all(const char * buffer, size_t size, const char * more, size_t more_size)
+{
+#ifdef _WIN32
+  int n;
+
+  output.written += size + more_size;
+  for (; size; buffer += n, size -= n) if ((n = _write(output.descriptor, buffer, (unsigned int)size)) < 0) return -1;
+  for (; more_size; more += n, more_size -= n)
+    if ((n = _write(output.descriptor, more, (unsigned int)more_size)) < 0) return -1;
+#else
+  struct iovec v[2];
+  ssize_t n;
+
+  output.written += size + more_size;
+  while (size || more_size)
+  {
+    v[0].iov_base = (void *)buffer; v[0].iov_len = size;
+    v[1].iov_base = (void *)more; v[1].iov_len = more_size;
+    if ((n = writev(output.descriptor, v, 2)) < 0) { if (errno == EINTR) continue; return -1; }
+    if ((size_t)n < size) { buffer += n; size -= n; }
+    else { more += n - size; more_size -= n - size; size = 0; }
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,50 @@
+/* output.h - Buffered output (with escaping) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _OUTPUT_H_
+#define _OUTPUT_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include <stddef.h>  /* size_t */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define OUTPUT_BUFFER_SIZE 0x10000  /* 65536 */
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+const char * output_open(const char * path);
+const char * output_close(void);
+size_t output_count(void);
+void output_flush(void);
+void output_write(const void * buffer, size_t size);
+void output_string(const char * string);
+void output_line(const char * string);
+void output_char(int c);
+void output_format(const char * format, ...);
+void output_json(const char * string);
+void output_html(const char * string);
+void output_csv_value(const char * string);
+
+
+#endif  /* (prevent multiple inclusion) */
@@ -0,0 +1,236 @@
+/* replica.c - Load balancing and failover among replicas (equivalent databases) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <sys/stat.h>    /* fstat, (struct) stat, S_IRUSR, S_ISREG, S_IWGRP, S_IWOTH, S_IWUSR, _S_IREAD, _S_IWRITE */
+#include <errno.h>       /* EINTR, errno */
+#include <fcntl.h>       /* fcntl, (struct) flock, F_SETLK, F_SETLKW, F_UNLCK, F_WRLCK, open, O_CREAT, O_NOFOLLOW, O_RDWR,
+                            _O_BINARY, _O_CREAT, _O_RDWR */
+#ifdef _WIN32
+#  include <io.h>        /* _close, _lseek, _locking, _open, _read, _write */
+#  include <process.h>   /* _getpid */
+#  include <sys/locking.h>  /* _LK_LOCK, _LK_UNLCK */
+#endif
+#include <stdio.h>       /* SEEK_SET, snprintf */
+#include <stdlib.h>      /* getenv */
+#include <string.h>      /* memset, strlen */
+#include <time.h>        /* time, time_t */
+#ifndef _WIN32
+#  include <unistd.h>    /* close, geteuid, getpid, lseek, read, write */
+#endif
+#include "replica.h"     /* (struct) replica_record, (struct) replica_set, REPLICA_LEAST, REPLICA_MAX */
+
+
+/*************
+ * Constants *
+ *************/
+
+static const char * STR_STATE_FORMAT = "%s/dumprows%08lx.state";
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define REPLICA_EJECT_SECONDS 30  /* how long a replica is ejected after it fails (multiplied by consecutive failures) */
+#define REPLICA_BACKOFF_MAX 10  /* maximum multiple of REPLICA_EJECT_SECONDS */
+#define REPLICA_STALE_SECONDS 600  /* requests outstanding longer than this are assumed to have been abandoned */
+
+/* FNV-1a is used to hash the command lines into the name of the state file. */
+#define HASH_BASIS 0x811C9DC5UL
+#define HASH_PRIME 0x01000193UL
+
+
+/*********************************
+ * Private Function Declarations *
+ *********************************/
+
+int load_state(struct replica_set * set);
+void store_state(struct replica_set * set);
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Begin choosing among a set of replicas, by opening (or creating) the file in which their state is shared.  If the file
+ * cannot be opened, the replicas are still chosen (and failed over), but without regard to other processes.
+ *   set:  receives the state of the replicas
+ *   commands:  command line for each replica (which should invoke a database utility)
+ *   count:  number of replicas (no more than REPLICA_MAX)
+ *   policy:  REPLICA_LEAST or REPLICA_ROUND_ROBIN
+ */
+void replica_open(struct replica_set * set, const char ** commands, int count, int policy)
+{
+  unsigned long h = HASH_BASIS;
+  const char * p;
+  int i;
+#ifndef _WIN32
+  struct stat s;
+#endif
+
+  memset(set, 0, sizeof(struct replica_set));
+  set->count = count; set->policy = policy;
+
+  /* The file is named for the command lines, so that a change to the set of replicas begins a new state. */
+  for (i = 0; i < count; ++i)
+    for (p = commands[i]; ; ++p) { h = ((h ^ (unsigned char)*p) * HASH_PRIME) & 0xFFFFFFFFUL; if (!*p) break; }
+#ifdef _WIN32
+  if (!(p = getenv("TMP")) && !(p = getenv("TEMP"))) p = ".";
+  set->state.cursor = _getpid();
+#else
+  if (!(p = getenv("TMPDIR")) || !*p) p = "/tmp";
+  set->state.cursor = getpid();
+#endif
+  if (snprintf(set->path, JB_PATH_MAX_LENGTH, STR_STATE_FORMAT, p, h) >= JB_PATH_MAX_LENGTH) { set->descriptor = -1; return; }
+#ifdef _WIN32
+  set->descriptor = _open(set->path, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+  /* The path is predictable, so the file must belong to this user, and must not be writable by anyone else. */
+  if ((set->descriptor = open(set->path, O_RDWR | O_CREAT | O_NOFOLLOW, S_IRUSR | S_IWUSR)) >= 0 &&
+      (fstat(set->descriptor, &s) || !S_ISREG(s.st_mode) || s.st_uid != geteuid() || (s.st_mode & (S_IWGRP | S_IWOTH))))
+    replica_close(set);
+#endif
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Choose a replica (which is then outstanding until it is released).  Replicas that are ejected are chosen only if every
+ * other replica has been tried already (and then the one whose ejection ends soonest).  Otherwise, the policy applies:
+ * either the replica with the fewest outstanding requests, or the next in turn (which also breaks ties).
+ *   set:  state of the replicas
+ *   tried:  bit mask of replicas that have been tried already (and so should not be chosen)
+ * Return Value:  Index of the replica, or -1 if every replica has been tried already.
+ */
+int replica_acquire(struct replica_set * set, unsigned long tried)
+{
+  struct replica_record * r, * q = NULL;
+  time_t t = time(NULL);
+  int i, j, k = -1, e, f;
+
+  e = load_state(set);
+  for (j = 0; j < set->count; ++j)
+  {
+    i = (int)((set->state.cursor + j) % set->count);
+    if (tried & (1UL << i)) continue;
+    r = set->state.records + i;
+    if (r->outstanding && t - r->touched > REPLICA_STALE_SECONDS) r->outstanding = 0;
+
+    if (q)
+    {
+      if ((f = (r->ejected > t)) != (q->ejected > t)) { if (f) continue; }
+      else if (f) { if (r->ejected >= q->ejected) continue; }
+      else if (set->policy != REPLICA_LEAST || r->outstanding >= q->outstanding) continue;
+    }
+    q = r; k = i;
+  }
+
+  if (q) { ++q->outstanding; q->touched = t; set->state.cursor = k + 1; }
+  if (!e) store_state(set);
+  return k;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Release a replica (chosen by replica_acquire), noting whether or not the request showed it to be healthy.  A replica
+ * that fails is ejected, for longer each time it fails in a row.
+ *   set:  state of the replicas
+ *   index:  index of the replica
+ *   health:  REPLICA_HEALTHY, REPLICA_UNHEALTHY, or REPLICA_UNKNOWN (e.g., if the query itself was not valid)
+ */
+void replica_release(struct replica_set * set, int index, int health)
+{
+  struct replica_record * r = set->state.records + index;
+  time_t t = time(NULL);
+  int e = load_state(set);
+
+  if (r->outstanding > 0) --r->outstanding;
+  r->touched = t;
+  if (health == REPLICA_HEALTHY) { r->failures = 0; r->ejected = 0; }
+  else if (health == REPLICA_UNHEALTHY)
+    r->ejected = t + REPLICA_EJECT_SECONDS * ((++r->failures < REPLICA_BACKOFF_MAX) ? r->failures : REPLICA_BACKOFF_MAX);
+  if (!e) store_state(set);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * End choosing among a set of replicas, by closing the file in which their state is shared.
+ *   set:  state of the replicas
+ */
+void replica_close(struct replica_set * set)
+{
+#ifdef _WIN32
+  if (set->descriptor >= 0) _close(set->descriptor);
+#else
+  if (set->descriptor >= 0) close(set->descriptor);
+#endif
+  set->descriptor = -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Lock the state file (waiting for any other process to unlock it), and read the shared state.  (If the file is new, or was
+ * written by a different version of this program, the state is reset.)  This should be followed by store_state.
+ *   set:  state of the replicas
+ * Return Value:  Zero on success; otherwise, nonzero (in which case the state is as this process last knew it).
+ */
+int load_state(struct replica_set * set)
+{
+  unsigned long c = set->state.cursor;
+  int d = set->descriptor, n;
+#ifndef _WIN32
+  struct flock k;
+#endif
+
+  if (d < 0) return -1;
+#ifdef _WIN32
+  /* On Win32, the first byte is locked (which _locking attempts once per second, for up to ten seconds). */
+  if (_lseek(d, 0, SEEK_SET) || _locking(d, _LK_LOCK, 1)) return -1;
+  n = _read(d, &set->state, sizeof(set->state));
+#else
+  memset(&k, 0, sizeof(struct flock));
+  k.l_type = F_WRLCK; k.l_whence = SEEK_SET;
+  while (fcntl(d, F_SETLKW, &k)) if (errno != EINTR) return -1;
+  n = (lseek(d, 0, SEEK_SET) == 0) ? read(d, &set->state, sizeof(set->state)) : -1;
+#endif
+  if (n != sizeof(set->state)) { memset(&set->state, 0, sizeof(set->state)); set->state.cursor = c; }
+  return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Write the shared state to the state file, and unlock it (after load_state).  If the state cannot be written in full (e.g.,
+ * because the disk is full), the file is closed, and this process keeps the state to itself from then on.
+ *   set:  state of the replicas
+ */
+void store_state(struct replica_set * set)
+{
+  int d = set->descriptor, n;
+#ifdef _WIN32
+  n = (_lseek(d, 0, SEEK_SET) == 0) ? _write(d, &set->state, sizeof(set->state)) : -1;
+  if (!_lseek(d, 0, SEEK_SET)) _locking(d, _LK_UNLCK, 1);
+#else
+  struct flock k;
+
+  n = (lseek(d, 0, SEEK_SET) == 0) ? write(d, &set->state, sizeof(set->state)) : -1;
+  memset(&k, 0, sizeof(struct flock));
+  k.l_type = F_UNLCK; k.l_whence = SEEK_SET;
+  fcntl(d, F_SETLK, &k);
+#endif
+  if (n != (int)sizeof(set->state)) replica_close(set);
+}
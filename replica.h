@@ -0,0 +1,80 @@
+/* replica.h - Load balancing and failover among replicas (equivalent databases) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _REPLICA_H_
+#define _REPLICA_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include <time.h>  /* time_t */
+#include "jb.h"    /* JB_PATH_MAX_LENGTH */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define REPLICA_MAX 0x10  /* 16 */
+
+/* Policies by which a replica is chosen */
+#define REPLICA_LEAST 0x1  /* the replica with the fewest outstanding requests */
+#define REPLICA_ROUND_ROBIN 0x2  /* each replica in turn */
+
+/* How a request went, as far as the health of the replica is concerned (see replica_release) */
+#define REPLICA_HEALTHY 1
+#define REPLICA_UNKNOWN 0
+#define REPLICA_UNHEALTHY (-1)
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* What every process knows about a replica:  how many requests are outstanding, how many have failed in a row, when it
+ * was last used, and until when it is ejected (i.e., not chosen unless every other replica has been tried already).
+ */
+struct replica_record
+{
+  long outstanding, failures;
+  time_t touched, ejected;
+};
+
+/* The state shared by every process that queries a set of replicas.  It is kept in a file (named for the set of command
+ * lines, in the temporary directory) that is locked while it is read and written.
+ */
+struct replica_set
+{
+  int descriptor, count, policy;
+  char path[JB_PATH_MAX_LENGTH];
+  struct
+  {
+    unsigned long cursor;
+    struct replica_record records[REPLICA_MAX];
+  } state;
+};
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+void replica_open(struct replica_set * set, const char ** commands, int count, int policy);
+int replica_acquire(struct replica_set * set, unsigned long tried);
+void replica_release(struct replica_set * set, int index, int health);
+void replica_close(struct replica_set * set);
+
+
+#endif  /* (prevent multiple inclusion) */
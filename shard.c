@@ -0,0 +1,989 @@
+/* shard.c - Fan-out of a query across shards (database files or connections) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <ctype.h>      /* isalnum, isdigit, isspace */
+#include <errno.h>      /* errno */
+#include <stdio.h>      /* snprintf, sprintf */
+#include <stdlib.h>     /* atoi, calloc, free, malloc, qsort, strtod, strtol, strtoll */
+#include <string.h>     /* memcpy, memset, strcmp, strcpy, strerror, strlen, strrchr, strspn, _stricmp, _strnicmp */
+#include <time.h>       /* clock, time */
+#ifndef _WIN32
+#  include <strings.h>  /* strcasecmp, strncasecmp */
+#endif
+#include "jb.h"         /* jb_trim */
+#include "shard.h"      /* (struct) shard_key, (struct) shard_plan, (struct) shard_row, (struct) shard_scan, (struct) shard_set,
+                           SHARD_BINARY, SHARD_KEY_MAX, SHARD_NULLS_FIRST, SHARD_ORDERED, SHARD_SAMPLE_BERNOULLI,
+                           SHARD_SAMPLE_ROWID, SHARD_SCAN_MIN */
+#include "source.h"     /* (struct) source, source_buffered, source_close, source_open, source_read, source_wait, SOURCE_SPOOL */
+
+
+/*************
+ * Constants *
+ *************/
+
+static const char * STR_ORDER = "ORDER BY must refer to columns of the results (to merge shards)";
+static const char * STR_COLLATION = "ORDER BY text must be collated byte by byte, e.g., COLLATE \"C\" (to merge shards)";
+static const char * STR_MIXED = "ORDER BY columns must not mix numbers and text (to merge shards)";
+static const char * STR_LIMIT = "LIMIT and OFFSET must be numbers at the end of the query (to query shards)";
+static const char * STR_SHARD_FORMAT = "Shard %d: %.*s";
+static const char * STR_LIMIT_FORMAT = "LIMIT %ld";
+static const char * STR_BOUNDS = "SELECT min(rowid), max(rowid)";
+static const char * STR_COUNT = ", count(*)";
+static const char * STR_LOWER_FORMAT = "rowid >= %lld";
+static const char * STR_UPPER_FORMAT = "rowid < %lld";
+static const char * STR_ROWID_FORMAT = "%s%lld";
+static const char * STR_RELTUPLES = "SELECT LEAST(c.reltuples, s.n_live_tup)::bigint FROM pg_class c "
+                                    "LEFT JOIN pg_stat_all_tables s ON s.relid = c.oid WHERE c.oid = to_regclass('";
+static const char * STR_BERNOULLI_FORMAT = "%.*s TABLESAMPLE BERNOULLI (%g);\n";
+
+/* Aggregate functions, which (in the result columns) prevent a query from being split into rowid ranges */
+static const char * STR_AGGREGATES[] = { "AVG", "COUNT", "GROUP_CONCAT", "MAX", "MIN", "SUM", "TOTAL", NULL };
+
+/* Collations that compare text byte by byte (as text sort keys are compared when merging shards) */
+static const char * STR_COLLATIONS[] = { "C", "POSIX", "BINARY", "\"C\"", "\"POSIX\"", "\"BINARY\"", NULL };
+
+/* Keywords that (outside of parentheses) prevent a query from being split into rowid ranges */
+static const char * STR_CLAUSES[] =
+  { "DISTINCT", "EXCEPT", "GROUP", "HAVING", "INTERSECT", "JOIN", "LIMIT", "OFFSET", "UNION", "VALUES", "WINDOW", NULL };
+
+/* Names by which SQLite refers to the rowid (any of which, as the only sort key, is the order of the ranges) */
+static const char * STR_ROWIDS[] = { "rowid", "_rowid_", "oid", NULL };
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#ifdef _WIN32
+/* On Win32, strcasecmp and strncasecmp are unavailable.  Corresponding functions _stricmp and _strnicmp are used instead. */
+#define strcasecmp _stricmp
+#define strncasecmp _strnicmp
+#endif
+
+#define is_word(c) (isalnum((unsigned char)(c)) || (c) == '_')
+
+/* An error message is prefixed with the number of the shard that failed, leaving this much less room for the message. */
+#define SHARD_PREFIX_MAX_LENGTH 0x20  /* 32 */
+
+/* A sample is drawn from twice as many rows as it comprises (which, if every row of the sample must be a row of the table,
+ * allows for gaps between rowids, and for the variance of a Bernoulli sample).
+ */
+#define SAMPLE_FACTOR 2
+
+
+/*********************************
+ * Private Function Declarations *
+ *********************************/
+
+const char * skip_quoted(const char * p);
+int find_keyword(const char * string, const char * p, const char ** keywords, int function);
+int is_keyword(const char * string, const char * p, const char * keyword);
+int strip_word(char * string, const char * word);
+int find_clauses(const char * query, const char ** from_ptr, const char ** where_ptr, const char ** order_ptr,
+                 const char ** end_ptr);
+int find_column(const char * query, const char * from, const char * name);
+int probe_rowids(const char * command, const char * table, long long * first_ptr, long long * last_ptr, long long * count_ptr);
+const char * parse_key(char * string, struct shard_key * key);
+int start_shard(struct shard_set * set);
+int fail_shard(struct shard_set * set, int index, const char * error);
+int read_combined(struct shard_set * set);
+int read_next(struct shard_set * set);
+int read_merged(struct shard_set * set);
+const char * copy_heading(struct shard_set * set, struct source * source);
+const char * decide_keys(struct shard_set * set);
+const char * check_row(struct shard_set * set, struct source * source);
+int compare_rows(struct shard_set * set, struct source * a, struct source * b);
+int parse_number(const char * value, double * number_ptr);
+const char * keep_row(struct shard_row * row, char ** fields, int count, long index);
+int compare_indexes(const void * a, const void * b);
+unsigned long long random_next(unsigned long long * state);
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Plan how to combine the results of a query on each shard, by finding the ORDER BY, LIMIT, and OFFSET clauses of the
+ * outermost query (i.e., outside of parentheses and quotes).  A LIMIT applies to each shard as well as to the results
+ * overall, but an OFFSET applies only overall (so the query for each shard is rewritten without it).
+ *   query:  query (SQL SELECT statement)
+ *   plan:  receives plan (whose buffer, if non-null, should be freed with free)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * shard_plan(const char * query, struct shard_plan * plan)
+{
+  const char * p, * q, * o = NULL, * l = NULL, * f = NULL, * e, * k;
+  char * d, * r;
+  int c = 0;
+
+  memset(plan, 0, sizeof(struct shard_plan));
+  plan->limit = -1;
+
+  for (p = query; *p; ++p)
+  {
+    if (*p == '\'' || *p == '"') { if (!*(p = skip_quoted(p))) break; continue; }
+    if (*p == '(') ++c;
+    else if (*p == ')') --c;
+    else if (c) continue;
+    else if (is_keyword(query, p, "ORDER"))
+    {
+      for (q = p + 5; isspace((unsigned char)*q); ++q);
+      if (is_keyword(query, q, "BY")) { o = q + 2; l = f = NULL; }
+    }
+    else if (is_keyword(query, p, "LIMIT")) l = p;
+    else if (is_keyword(query, p, "OFFSET")) f = p;
+  }
+  for (e = p; e > query && (isspace((unsigned char)e[-1]) || e[-1] == ';'); --e);
+
+  /* Memory is needed for the names of sort keys and the rewritten query (neither of which can be longer than the query). */
+  if (!(plan->buffer = d = malloc(2 * (e - query) + 0x20))) return strerror(errno);
+
+  /* Parse the sort keys, which are separated by commas (outside of parentheses and quotes). */
+  if (o)
+  {
+    for (k = (l && (!f || l < f)) ? l : (f ? f : e), p = o; p < k; p = q + 1)
+    {
+      for (c = 0, q = p; q < k; ++q)
+      {
+        if (*q == '\'' || *q == '"') { if ((q = skip_quoted(q)) >= k) break; continue; }
+        if (*q == '(') ++c; else if (*q == ')') --c; else if (!c && *q == ',') break;
+      }
+      if (q > k) q = k;
+      if (plan->key_count == SHARD_KEY_MAX) return STR_ORDER;
+      memcpy(d, p, q - p); d[q - p] = '\0';
+      if (p = parse_key(d, plan->keys + plan->key_count++)) return p;
+      d += strlen(d) + 1;
+    }
+  }
+
+  /* Parse the limit (LIMIT n, or LIMIT m, n as in SQLite) and offset (OFFSET m). */
+  if (l)
+  {
+    for (p = l + 5; isspace((unsigned char)*p); ++p);
+    if (is_keyword(query, p, "ALL")) p += 3;
+    else if (!isdigit((unsigned char)*p)) return STR_LIMIT;
+    else
+    {
+      plan->limit = strtol(p, &r, 10);
+      for (p = r; isspace((unsigned char)*p); ++p);
+      if (*p == ',')
+      {
+        for (++p; isspace((unsigned char)*p); ++p);
+        if (!isdigit((unsigned char)*p)) return STR_LIMIT;
+        plan->offset = plan->limit; plan->limit = strtol(p, &r, 10); p = r;
+      }
+    }
+    for (; isspace((unsigned char)*p); ++p);
+    if (p < e && p != f) return STR_LIMIT;
+  }
+  if (f)
+  {
+    for (p = f + 6; isspace((unsigned char)*p); ++p);
+    if (!isdigit((unsigned char)*p)) return STR_LIMIT;
+    plan->offset = strtol(p, &r, 10);
+    for (p = r; isspace((unsigned char)*p); ++p);
+    if (p < e && p != l) return STR_LIMIT;
+  }
+
+  /* If there is an offset, each shard must return the rows that precede it as well (and the offset is applied overall). */
+  if (plan->offset)
+  {
+    p = (l && (!f || l < f)) ? l : f;
+    plan->query = d;
+    memcpy(d, query, p - query); d += p - query;
+    if (plan->limit >= 0) sprintf(d, STR_LIMIT_FORMAT, plan->limit + plan->offset); else *d = '\0';
+  }
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Split a query on a single (SQLite) table into rowid ranges, so that the table can be scanned by several database
+ * utilities at once.  This is possible only if each row of the results depends on one row of the table (so there can
+ * be no join, grouping, aggregation, DISTINCT, LIMIT, etc.).  The range of rowids in the table is queried first, and
+ * the query for each range has a condition on the rowid (in addition to any WHERE condition).  Ordering by rowid is
+ * preserved by reading the ranges in order, and ordering by anything else by merging them (per the plan).
+ *   command:  command line (which should invoke sqlite3 or spatialite)
+ *   query:  query (SQL SELECT statement)
+ *   count:  number of ranges (no more than SHARD_MAX)
+ *   scan:  receives how the query is split (whose buffer and plan buffer, if non-null, should be freed with free)
+ * Return Value:  The number of ranges, or zero if the query cannot (or need not) be split.
+ */
+int shard_scan(const char * command, const char * query, int count, struct shard_scan * scan)
+{
+  const char * p, * q, * f, * w, * o, * e;
+  char * d;
+  long long a, b, k;
+  int i, j, n;
+
+  memset(scan, 0, sizeof(struct shard_scan));
+  scan->plan.limit = -1;
+  if (count < 2 || count > SHARD_MAX || !find_clauses(query, &f, &w, &o, &e)) return 0;
+
+  /* If the query is ordered by rowid, the ranges are read in order (ascending or descending).  Otherwise, they are merged,
+   * which is possible only if every sort key is a column of the results (if not, the query is executed as is).
+   */
+  if (o)
+  {
+    if (shard_plan(query, &scan->plan)) return 0;
+    if (scan->plan.key_count == 1 && (q = scan->plan.keys[0].name))
+      for (i = 0; STR_ROWIDS[i]; ++i) if (!strcasecmp(q, STR_ROWIDS[i])) { scan->flags = SHARD_ORDERED; scan->plan.key_count = 0; break; }
+    for (i = 0; i < scan->plan.key_count; ++i)
+      if ((q = scan->plan.keys[i].name) && !find_column(query, f, q)) return 0;
+  }
+
+  /* Memory is needed for the name of the table, and the query for each range. */
+  if (!(scan->buffer = d = malloc((count + 1) * (e - query + 0x60)))) return 0;
+  for (p = f + 4, q = w ? w : (o ? o : e); p < q && isspace((unsigned char)*p); ++p);
+  for (; q > p && isspace((unsigned char)q[-1]); --q);
+  if (p == q) return 0;
+  memcpy(d, p, q - p); d[q - p] = '\0';
+
+  /* Query the range of rowids.  (If this fails, e.g. because the table has no rowid, the query is not split.) */
+  if (probe_rowids(command, d, &a, &b, NULL) || b - a < SHARD_SCAN_MIN) return 0;
+
+  /* Compose the query for each range:  the rowid condition is inserted before any WHERE condition (which is parenthesized)
+   * or ORDER BY clause.  The first range has no lower bound, and the last no upper bound (so that every row is included).
+   */
+  for (k = (b - a) / count + 1, i = 0; i < count; ++i)
+  {
+    j = (scan->flags && scan->plan.keys[0].descending) ? count - 1 - i : i;
+    scan->commands[i] = command; scan->inputs[i] = scan->input[i];
+    scan->input[i][0] = d += strlen(d) + 1; scan->input[i][1] = NULL;
+    n = (int)((w ? w : (o ? o : e)) - query);
+    d += sprintf(d, "%.*s WHERE ", n, query);
+    if (j) d += sprintf(d, STR_LOWER_FORMAT, a + j * k);
+    if (j && j < count - 1) d += sprintf(d, " AND ");
+    if (j < count - 1) d += sprintf(d, STR_UPPER_FORMAT, a + (j + 1) * k);
+    if (w) { p = w + 5; q = o ? o : e; d += sprintf(d, " AND (%.*s)", (int)(q - p), p); }
+    if (o) d += sprintf(d, " %.*s", (int)(e - o), o);
+    strcpy(d, ";\n");
+  }
+  return scan->count = count;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Rewrite a query on a single table so that only a random sample of the table is read (rather than all of it), using the
+ * database's own means of sampling.  In SQLite, random rowids (between the least and greatest in the table) are looked up;
+ * in PostgreSQL, the table is sampled by TABLESAMPLE BERNOULLI.  Either way, about SAMPLE_FACTOR times as many rows as the
+ * sample comprises are read (given the number of rows in the table, which in PostgreSQL is estimated), unless too few would
+ * be found (e.g., because rowids are sparse), in which case the query is not rewritten.  The sample is then drawn from the
+ * rows that are read (see shard_reservoir), so that it is the right size.  As for shard_scan, each row of the results must
+ * depend on one row of the table, and there can be no WHERE or ORDER BY clause (since the rows read are not filtered).
+ *   command:  command line (which should invoke sqlite3, spatialite, or psql)
+ *   query:  query (SQL SELECT statement)
+ *   size:  size of the sample (number of rows)
+ *   method:  SHARD_SAMPLE_ROWID (SQLite) or SHARD_SAMPLE_BERNOULLI (PostgreSQL)
+ *   scan:  receives the rewritten query, as a scan of a single range (whose buffer, if non-null, should be freed with free)
+ * Return Value:  1 if the query is rewritten, or zero if it cannot (or need not) be.
+ */
+int shard_sample(const char * command, const char * query, long size, int method, struct shard_scan * scan)
+{
+  struct source s;
+  const char * p, * q, * f, * w, * o, * e, * input[4];
+  unsigned long long g = (unsigned long long)time(NULL) ^ ((unsigned long long)clock() << 32) ^ (size_t)scan;
+  char * d, * t;
+  long long a, b, c, n;
+  double r = 0;
+  long long i;
+
+  memset(scan, 0, sizeof(struct shard_scan));
+  scan->plan.limit = -1;
+  if (!find_clauses(query, &f, &w, &o, &e) || w || o) return 0;
+
+  /* Memory is needed for the name of the table (with its quotes doubled), and the rewritten query. */
+  for (p = f + 4; isspace((unsigned char)*p); ++p);
+  if (p == e) return 0;
+  n = (method == SHARD_SAMPLE_ROWID) ? SAMPLE_FACTOR * SAMPLE_FACTOR * size : 0;
+  if (!(scan->buffer = d = malloc(3 * (e - query) + 0x40 + n * 0x15))) return 0;
+  for (q = p; q < e; *d++ = *q++) if (*q == '\'' && method == SHARD_SAMPLE_BERNOULLI) *d++ = '\'';
+  *d++ = '\0';
+  scan->commands[0] = command; scan->inputs[0] = scan->input[0]; scan->input[0][0] = d;
+
+  /* In SQLite, the rowids to look up are chosen uniformly between the least and the greatest (and those that are missing
+   * are simply not found), as many as are needed to find about SAMPLE_FACTOR times the size of the sample.  If the table is
+   * small, or fewer than half of the rowids in its range are used (so that most lookups would miss), every row is read.
+   */
+  if (method == SHARD_SAMPLE_ROWID)
+  {
+    if (probe_rowids(command, scan->buffer, &a, &b, &c) || c < SAMPLE_FACTOR * size || b - a + 1 > SAMPLE_FACTOR * c)
+      return 0;
+    n = (SAMPLE_FACTOR * size * (b - a + 1) + c - 1) / c;
+    d += sprintf(d, "%.*s WHERE rowid IN (", (int)(e - query), query);
+    for (i = 0; i < n; ++i)
+      d += sprintf(d, STR_ROWID_FORMAT, i ? "," : "", a + (long long)(random_next(&g) % (unsigned long long)(b - a + 1)));
+    strcpy(d, ");\n");
+    return scan->count = 1;
+  }
+
+  /* In PostgreSQL, the sampling rate depends on the estimated number of rows (which is unknown if the table has never been
+   * analyzed).  The planner's estimate is stale if rows have since been deleted, so the live row count kept by the statistics
+   * collector is used if it is less.  If the whole table would be read anyway, the query is not rewritten.
+   */
+  input[0] = STR_RELTUPLES; input[1] = scan->buffer; input[2] = "');\n"; input[3] = NULL;
+  if (!source_open(&s, command, input, 0) && source_read(&s) > 0 && source_read(&s) == 1) r = strtod(s.fields[0], &t);
+  source_close(&s);
+  if (r < 1 || (r = 100.0 * SAMPLE_FACTOR * size / r) >= 100) return 0;
+  sprintf(d, STR_BERNOULLI_FORMAT, (int)(e - query), query, r);
+  return scan->count = 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Begin a query on a set of shards.  No utility is spawned until the first record is read.
+ *   set:  receives the state of the query
+ *   commands:  command line for each shard (which should invoke a database utility)
+ *   inputs:  input for each shard (see source_open)
+ *   count:  number of shards
+ *   workers:  maximum number of shards to query at once
+ *   flags:  zero, or any combination of SHARD_NULLS_FIRST, SHARD_ORDERED, and the flags for source_open
+ *   plan:  how to combine the results (or NULL if they are simply concatenated)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * shard_open(struct shard_set * set, const char ** commands, const char *** inputs,
+                        int count, int workers, int flags, struct shard_plan * plan)
+{
+  memset(set, 0, sizeof(struct shard_set));
+  set->commands = commands; set->inputs = inputs; set->count = count; set->flags = flags; set->plan = plan;
+  set->workers = (workers > 0) ? workers : 1;
+  set->limit = plan ? plan->limit : -1; set->offset = plan ? plan->offset : 0;
+  return (set->sources = calloc(count, sizeof(struct source))) ? NULL : strerror(errno);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Start querying a set of shards (as many at once as there are workers) before the first record is read, so that the
+ * query runs concurrently with whatever else is done first (e.g., reading the results of another query).
+ *   set:  state of the query
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * shard_start(struct shard_set * set)
+{
+  while (set->running < set->workers && set->started < set->count) if (start_shard(set)) return set->message;
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Sample the combined results (after any offset and limit):  every row is read, but only a random sample of them (each
+ * equally likely to be included) is output, in the order in which they were read.  (Only the sample is kept in memory.)
+ *   set:  state of the query
+ *   size:  size of the sample (number of rows)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * shard_reservoir(struct shard_set * set, long size)
+{
+  if (!(set->reservoir = calloc(size, sizeof(struct shard_row)))) return strerror(errno);
+  set->sample = size; set->next = -1;
+  set->seed = (unsigned long long)time(NULL) ^ ((unsigned long long)clock() << 32) ^ (size_t)set;
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the next record of the combined results.  The first record is the column headings (from whichever shard provides
+ * them first).  Rows are then read from each shard in turn (as they are output), unless there are sort keys, in which
+ * case they are merged (from each shard's output, which is spooled, and sorted already).
+ *   set:  state of the query
+ * Return Value:  On success, the number of fields in the record (which are in the fields member of set);
+ *   zero if there are no more records; or -1 on error (in which case shard_close returns the error message).
+ */
+int shard_read(struct shard_set * set)
+{
+  struct shard_row * r;
+  const char * p;
+  long i;
+  int n;
+
+  /* Unless the results are sampled, each record is output as it is read.  Otherwise, after the column headings, every row
+   * is read first:  each is kept (in place of one kept already, once the sample is full) with the probability that keeps
+   * the sample uniform (i.e., Algorithm R).  The rows kept are then put back in order.
+   */
+  if (!set->sample || !set->headed) return read_combined(set);
+  if (set->next < 0)
+  {
+    for (; (n = read_combined(set)) > 0; ++set->seen)
+    {
+      i = (set->seen < set->sample) ? set->seen : (long)(random_next(&set->seed) % (unsigned long long)(set->seen + 1));
+      if (i < set->sample && (p = keep_row(set->reservoir + i, set->fields, n, set->seen)))
+      {
+        snprintf(set->message, SOURCE_MESSAGE_MAX_LENGTH, "%s", p); return -1;
+      }
+    }
+    if (n < 0) return n;
+    set->kept = (set->seen < set->sample) ? set->seen : set->sample; set->next = 0;
+    qsort(set->reservoir, set->kept, sizeof(struct shard_row), compare_indexes);
+  }
+  if (set->next == set->kept) return 0;
+  r = set->reservoir + set->next++;
+  set->fields = r->fields; return set->field_count = r->count;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * End a query on a set of shards, closing every row source (see source_close), and free memory.
+ *   set:  state of the query
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * shard_close(struct shard_set * set)
+{
+  const char * p;
+  int i;
+
+  for (i = 0; i < set->started; ++i)
+    if ((p = source_close(set->sources + i)) && !set->message[0]) fail_shard(set, i, p);
+  if (set->reservoir) for (i = 0; i < set->sample; ++i) free(set->reservoir[i].fields);
+  free(set->sources); free(set->heading); free(set->reservoir);
+  set->sources = NULL; set->heading = NULL; set->reservoir = NULL;
+  return set->message[0] ? set->message : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Skip a quoted string (or identifier) in a query.
+ *   p:  opening quote
+ * Return Value:  Pointer to the closing quote (or the end of the query if there is none).
+ */
+const char * skip_quoted(const char * p)
+{
+  char c = *p;
+
+  while (*++p && *p != c);
+  return p;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine whether or not any of a list of keywords occurs at a given position in a query (see is_keyword).
+ *   string:  query
+ *   p:  position in query
+ *   keywords:  array of keywords (in uppercase), terminated by NULL
+ *   function:  nonzero if the keywords are function names (which count only if followed by an opening parenthesis)
+ * Return Value:  Nonzero if any of the keywords occurs at the position; otherwise, zero.
+ */
+int find_keyword(const char * string, const char * p, const char ** keywords, int function)
+{
+  const char * q;
+  int i;
+
+  if (!is_word(*p) || p > string && is_word(p[-1])) return 0;
+  for (i = 0; keywords[i]; ++i) if (is_keyword(string, p, keywords[i]))
+  {
+    if (!function) return 1;
+    for (q = p + strlen(keywords[i]); isspace((unsigned char)*q); ++q);
+    if (*q == '(') return 1;
+  }
+  return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine whether or not a keyword (as a whole word, in any case) occurs at a given position in a query.
+ *   string:  query
+ *   p:  position in query
+ *   keyword:  keyword (in uppercase)
+ * Return Value:  Nonzero if the keyword occurs at the position; otherwise, zero.
+ */
+int is_keyword(const char * string, const char * p, const char * keyword)
+{
+  size_t n = strlen(keyword);
+  return (p == string || !is_word(p[-1])) && !strncasecmp(p, keyword, n) && !is_word(p[n]);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Strip a word (in any case) from the end of a (trimmed) string, if it is there.
+ *   string:  string
+ *   word:  word (in uppercase)
+ * Return Value:  Nonzero if the word was stripped; otherwise, zero.
+ */
+int strip_word(char * string, const char * word)
+{
+  size_t n = strlen(string), k = strlen(word);
+
+  if (n <= k || strcasecmp(string + n - k, word) || !isspace((unsigned char)string[n - k - 1])) return 0;
+  for (n -= k; n && isspace((unsigned char)string[n - 1]); --n);
+  string[n] = '\0'; return 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Find the FROM, WHERE, and ORDER BY clauses of a query on a single table (outside of parentheses and quotes), making sure
+ * that each row of the results depends on one row of the table (see shard_scan).
+ *   query:  query (SQL SELECT statement)
+ *   from_ptr:  receives pointer to the FROM keyword
+ *   where_ptr:  receives pointer to the WHERE keyword (or NULL if there is none)
+ *   order_ptr:  receives pointer to the ORDER keyword (or NULL if there is none)
+ *   end_ptr:  receives pointer to the end of the query (before any terminating semicolon)
+ * Return Value:  Nonzero if the query is on a single table (as above); otherwise, zero.
+ */
+int find_clauses(const char * query, const char ** from_ptr, const char ** where_ptr, const char ** order_ptr,
+                 const char ** end_ptr)
+{
+  const char * p, * f = NULL, * w = NULL, * o = NULL;
+  int c = 0;
+
+  if (!is_keyword(query, query, "SELECT")) return 0;
+  for (p = query + 6; *p; ++p)
+  {
+    if (*p == '\'' || *p == '"') { if (!*(p = skip_quoted(p))) break; continue; }
+    if (is_keyword(query, p, "OVER") || !f && find_keyword(query, p, STR_AGGREGATES, 1)) return 0;
+    if (*p == '(') { if (f && !w && !o) return 0; ++c; }
+    else if (*p == ')') --c;
+    else if (c) continue;
+    else if (*p == ',') { if (f && !w && !o) return 0; }
+    else if (is_keyword(query, p, "FROM")) { if (!f) f = p; }
+    else if (is_keyword(query, p, "WHERE")) { if (f && !w && !o) w = p; }
+    else if (is_keyword(query, p, "ORDER")) o = p;
+    else if (find_keyword(query, p, STR_CLAUSES, 0)) return 0;
+  }
+  if (!f) return 0;
+  for (; p > query && (isspace((unsigned char)p[-1]) || p[-1] == ';'); --p);
+  *from_ptr = f; *where_ptr = w; *order_ptr = o; *end_ptr = p;
+  return 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine whether or not a sort key names a column of the results of a query on a single table (see find_clauses), so
+ * that the ranges of a scan can be merged by it.  The key must be the name of a column in the select list (or its alias),
+ * or a plain name if the select list includes every column (*).  Anything else (e.g., an expression, or a column that an
+ * alias renames) can be sorted only by the database.
+ *   query:  query (SQL SELECT statement)
+ *   from:  pointer to the FROM keyword
+ *   name:  name of sort key
+ * Return Value:  Nonzero if the key names a column of the results; otherwise, zero.
+ */
+int find_column(const char * query, const char * from, const char * name)
+{
+  const char * p, * q, * r, * s, * t;
+  size_t n = strlen(name);
+  int c;
+
+  for (p = query + 6; p < from; p = q + 1)
+  {
+    /* Find the end of the item (at a comma outside of parentheses and quotes), and trim it. */
+    for (c = 0, q = p; q < from; ++q)
+    {
+      if (*q == '\'' || *q == '"') { if ((q = skip_quoted(q)) >= from) break; continue; }
+      if (*q == '(') ++c; else if (*q == ')') --c; else if (!c && *q == ',') break;
+    }
+    if (q > from) q = from;
+    for (; p < q && isspace((unsigned char)*p); ++p);
+    for (r = q; r > p && isspace((unsigned char)r[-1]); --r);
+    if (r == p) continue;
+
+    /* An item that ends with * (i.e., every column of the table) includes any column that a plain name can name. */
+    if (r[-1] == '*')
+    {
+      for (s = name; is_word(*s); ++s);
+      if (n && !*s) return 1;
+      continue;
+    }
+
+    /* The name of the column is the last word (or quoted identifier) of the item, which is either the whole item, or follows
+     * a qualifier, AS, or (after a space) an expression that it aliases.  Following an operator, it is part of an expression.
+     */
+    if (r[-1] == '"') { for (s = r - 1; s > p && s[-1] != '"'; --s); t = s - 1; --r; if (s == p) continue; }
+    else { for (s = r; s > p && is_word(s[-1]); --s); t = s; }
+    if ((size_t)(r - s) != n || strncasecmp(s, name, n)) continue;
+    for (r = t; r > p && isspace((unsigned char)r[-1]); --r);
+    if (r == p || r[-1] == '.' || r < t && (is_word(r[-1]) || r[-1] == ')' || r[-1] == '"')) return 1;
+  }
+  return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Query the range of rowids in an SQLite table (and optionally the number of rows, which takes longer).
+ *   command:  command line (which should invoke sqlite3 or spatialite)
+ *   table:  name of table
+ *   first_ptr:  receives the least rowid
+ *   last_ptr:  receives the greatest rowid
+ *   count_ptr:  receives the number of rows (or NULL)
+ * Return Value:  Zero on success; otherwise (e.g., if the table is empty or has no rowid), nonzero.
+ */
+int probe_rowids(const char * command, const char * table, long long * first_ptr, long long * last_ptr, long long * count_ptr)
+{
+  struct source s;
+  const char * input[6];
+  long long a = -1, b = -1, c = 0;
+  char * t;
+
+  input[0] = STR_BOUNDS; input[1] = count_ptr ? STR_COUNT : ""; input[2] = " FROM "; input[3] = table;
+  input[4] = ";\n"; input[5] = NULL;
+  if (!source_open(&s, command, input, 0) && source_read(&s) > 0 && source_read(&s) == (count_ptr ? 3 : 2) &&
+      *s.fields[0] && *s.fields[1])
+  {
+    a = strtoll(s.fields[0], &t, 10);
+    b = *t ? -1 : strtoll(s.fields[1], &t, 10);
+    if (!*t && count_ptr) c = strtoll(s.fields[2], &t, 10);
+    if (*t) a = b = -1;
+  }
+  source_close(&s);
+  if (b < a) return -1;
+  *first_ptr = a; *last_ptr = b; if (count_ptr) *count_ptr = c;
+  return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parse a sort key (i.e., a term of the ORDER BY clause), which is modified in place.
+ *   string:  sort key (e.g., "t.name DESC", or "2")
+ *   key:  receives sort key
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * parse_key(char * string, struct shard_key * key)
+{
+  char * p = jb_trim(string), * q, * c;
+  size_t n;
+  int i;
+
+  memset(key, 0, sizeof(struct shard_key));
+  if ((strip_word(p, "FIRST") || strip_word(p, "LAST")) && !strip_word(p, "NULLS")) return STR_ORDER;
+  if (strip_word(p, "DESC")) key->descending = 1; else strip_word(p, "ASC");
+
+  /* Any collation (e.g., "name COLLATE \"C\"") is noted, and stripped. */
+  for (q = p; *q; ++q)
+  {
+    if (*q == '"') { if (!*(q = (char *)skip_quoted(q))) break; continue; }
+    if (is_keyword(p, q, "COLLATE")) break;
+  }
+  if (*q)
+  {
+    c = jb_trim(q + 7); *q = '\0'; p = jb_trim(p);
+    for (key->collation = -1, i = 0; STR_COLLATIONS[i]; ++i) if (!strcasecmp(c, STR_COLLATIONS[i])) key->collation = 1;
+  }
+  if (!(n = strlen(p))) return STR_ORDER;
+
+  /* The key is a column ordinal, a quoted identifier, or a (possibly qualified) column name. */
+  if (strspn(p, "0123456789") == n) { key->ordinal = atoi(p); return key->ordinal ? NULL : STR_ORDER; }
+  if (p[n - 1] == '"')
+  {
+    p[--n] = '\0';
+    if (!(q = strrchr(p, '"'))) return STR_ORDER;
+    key->name = q + 1; return NULL;
+  }
+  key->name = (q = strrchr(p, '.')) ? q + 1 : p;
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Start the next shard (i.e., spawn a database utility to query it).
+ *   set:  state of the query
+ * Return Value:  Zero on success; otherwise, -1.
+ */
+int start_shard(struct shard_set * set)
+{
+  const char * p;
+  int i = set->started++, f = set->flags & ~(SHARD_NULLS_FIRST | SHARD_ORDERED);
+
+  /* Output is spooled if it must be merged, or if it is to be read in order (but it is not this shard's turn yet). */
+  if (set->plan && set->plan->key_count || (set->flags & SHARD_ORDERED) && i != set->current) f |= SOURCE_SPOOL;
+  ++set->running;
+  return (p = source_open(set->sources + i, set->commands[i], set->inputs[i], f)) ? fail_shard(set, i, p) : 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Note the error that caused a query on a shard (and therefore on the set of shards) to fail.
+ *   set:  state of the query
+ *   index:  index of shard
+ *   error:  error message
+ * Return Value:  -1 (for convenience, as shard_read returns this on error).
+ */
+int fail_shard(struct shard_set * set, int index, const char * error)
+{
+  if (set->count > 1) snprintf(set->message, SOURCE_MESSAGE_MAX_LENGTH, STR_SHARD_FORMAT, index + 1,
+                               SOURCE_MESSAGE_MAX_LENGTH - SHARD_PREFIX_MAX_LENGTH, error);
+  else snprintf(set->message, SOURCE_MESSAGE_MAX_LENGTH, "%s", error);
+  return -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the next record of the combined results, after any offset and before any limit (see shard_read).
+ *   set:  state of the query
+ * Return Value:  Same as shard_read.
+ */
+int read_combined(struct shard_set * set)
+{
+  int n;
+
+  for (;;)
+  {
+    if (set->headed && !set->limit) return 0;
+    n = (set->plan && set->plan->key_count) ? read_merged(set) : read_next(set);
+    if (n <= 0) return n;
+    if (!set->headed) { set->headed = 1; return n; }
+    if (set->offset > 0) { --set->offset; continue; }
+    if (set->limit > 0) --set->limit;
+    return n;
+  }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the next record from whichever shard is next in turn.  Each shard is read until none of its output remains to be
+ * parsed (so that the others are not kept waiting), or if they are ordered, until it is finished.  When one is finished,
+ * the next is started in its place.
+ *   set:  state of the query
+ * Return Value:  Same as shard_read.
+ */
+int read_next(struct shard_set * set)
+{
+  struct source * s;
+  const char * p;
+  int n;
+
+  for (;;)
+  {
+    while (set->running < set->workers && set->started < set->count) if (start_shard(set)) return -1;
+    if (!set->running) return 0;
+
+    /* Skip shards that are finished. */
+    if (set->current >= set->started) set->current = 0;
+    s = set->sources + set->current;
+    if (!s->buffer) { ++set->current; continue; }
+
+    if ((n = source_read(s)) < 0) return fail_shard(set, set->current, s->message);
+    if (!n)
+    {
+      if (p = source_close(s)) return fail_shard(set, set->current, p);
+      --set->running; ++set->current; continue;
+    }
+    if (!source_buffered(s) && !(set->flags & SHARD_ORDERED)) ++set->current;
+
+    /* The column headings are output only once (the first record from every other shard is skipped). */
+    if (s->record_count == 1 && set->headed) continue;
+    set->fields = s->fields; return set->field_count = n;
+  }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the next record in sort order.  Initially, the first row from every shard is read (waiting for each in turn, and
+ * starting another whenever one finishes).  Thereafter, the least of the current rows is the next record.
+ *   set:  state of the query
+ * Return Value:  Same as shard_read.
+ */
+int read_merged(struct shard_set * set)
+{
+  struct source * s;
+  const char * p;
+  int n, i, j;
+
+  if (!set->primed)
+  {
+    for (set->primed = 1, set->last = -1, i = 0; i < set->count; ++i)
+    {
+      while (set->running < set->workers && set->started < set->count) if (start_shard(set)) return -1;
+      s = set->sources + i;
+      p = source_wait(s); --set->running;
+      if (p) return fail_shard(set, i, p);
+
+      /* Read the column headings (keeping a copy of the first), and then the first row. */
+      for (j = 0; j < 2; ++j)
+      {
+        if ((n = source_read(s)) < 0) return fail_shard(set, i, s->message);
+        if (!n) { if (p = source_close(s)) return fail_shard(set, i, p); break; }
+        if (!j && !set->heading && (p = copy_heading(set, s))) return fail_shard(set, i, p);
+      }
+    }
+    if (!set->heading) return 0;
+    if (p = decide_keys(set)) { snprintf(set->message, SOURCE_MESSAGE_MAX_LENGTH, "%s", p); return -1; }
+    set->fields = set->heading; return set->field_count = set->heading_count;
+  }
+
+  /* Advance the shard whose row was read last. */
+  if (set->last >= 0 && (s = set->sources + set->last)->buffer)
+  {
+    if ((n = source_read(s)) < 0) return fail_shard(set, set->last, s->message);
+    if (!n && (p = source_close(s))) return fail_shard(set, set->last, p);
+    if (n && (p = check_row(set, s))) return fail_shard(set, set->last, p);
+  }
+
+  /* Find the least of the current rows (favoring the first shard in case of a tie). */
+  for (j = -1, i = 0; i < set->count; ++i)
+    if (set->sources[i].buffer && (j < 0 || compare_rows(set, set->sources + i, set->sources + j) < 0)) j = i;
+  if ((set->last = j) < 0) return 0;
+  set->fields = set->sources[j].fields; return set->field_count = set->sources[j].field_count;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Copy the column headings (from the current record of a shard), and find the column of each sort key.
+ *   set:  state of the query
+ *   source:  row source whose current record is the column headings
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * copy_heading(struct shard_set * set, struct source * source)
+{
+  struct shard_key * k;
+  size_t n;
+  char * d;
+  int i, j;
+
+  for (n = 0, i = 0; i < source->field_count; ++i) n += sizeof(char *) + strlen(source->fields[i]) + 1;
+  if (!(set->heading = malloc(n))) return strerror(errno);
+  for (d = (char *)(set->heading + source->field_count), i = 0; i < source->field_count; ++i)
+  {
+    strcpy(set->heading[i] = d, source->fields[i]); d += strlen(d) + 1;
+  }
+  set->heading_count = source->field_count;
+
+  for (k = set->plan->keys, i = 0; i < set->plan->key_count; ++i, ++k)
+  {
+    if (!k->name) k->column = k->ordinal - 1;
+    else for (k->column = -1, j = 0; j < set->heading_count; ++j) if (!strcasecmp(k->name, set->heading[j])) { k->column = j; break; }
+    if (k->column < 0 || k->column >= set->heading_count) return STR_ORDER;
+  }
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Decide how the values of each sort key are compared (see compare_rows), from the first row of every shard:  as numbers if
+ * each value (that is not null) is a number, and otherwise as text, which must then be collated byte by byte (as the
+ * database would collate it, were it to compare the values as compare_rows does).
+ *   set:  state of the query
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * decide_keys(struct shard_set * set)
+{
+  struct shard_key * k;
+  struct source * s;
+  const char * x;
+  double u;
+  int i, j;
+
+  for (k = set->plan->keys, i = 0; i < set->plan->key_count; ++i, ++k)
+  {
+    for (k->numeric = -1, s = set->sources, j = 0; j < set->count; ++j, ++s)
+    {
+      if (!s->buffer || k->column >= s->field_count || !*(x = s->fields[k->column])) continue;
+      if (!parse_number(x, &u)) { k->numeric = 0; break; }
+      k->numeric = 1;
+    }
+    if (!k->numeric && (k->collation < 0 || !k->collation && !(set->flags & SHARD_BINARY))) return STR_COLLATION;
+  }
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Check the current row of a shard (after the first), whose values must be compared as decided (see decide_keys).  A key
+ * whose values have all been null so far is decided by this row.
+ *   set:  state of the query
+ *   source:  row source
+ * Return Value:  NULL if the row can be compared; otherwise, an error message.
+ */
+const char * check_row(struct shard_set * set, struct source * source)
+{
+  struct shard_key * k;
+  const char * x;
+  double u;
+  int i;
+
+  for (k = set->plan->keys, i = 0; i < set->plan->key_count; ++i, ++k)
+  {
+    if (k->column >= source->field_count || !*(x = source->fields[k->column])) continue;
+    if (k->numeric < 0)
+    {
+      if (!(k->numeric = parse_number(x, &u)) && (k->collation < 0 || !k->collation && !(set->flags & SHARD_BINARY)))
+        return STR_COLLATION;
+    }
+    else if (k->numeric && !parse_number(x, &u)) return STR_MIXED;
+  }
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compare the current rows of two shards by the sort keys.  The values of each key are compared as numbers or byte by byte,
+ * as decided (see decide_keys).  Empty values (i.e., nulls) sort first or last, as the database would.
+ *   set:  state of the query
+ *   a:  row source of one row
+ *   b:  row source of the other
+ * Return Value:  A negative number if a precedes b, a positive number if b precedes a, or zero if neither does.
+ */
+int compare_rows(struct shard_set * set, struct source * a, struct source * b)
+{
+  struct shard_key * k;
+  const char * x, * y;
+  double u, v;
+  int i, r;
+
+  for (k = set->plan->keys, i = 0; i < set->plan->key_count; ++i, ++k)
+  {
+    x = (k->column < a->field_count) ? a->fields[k->column] : "";
+    y = (k->column < b->field_count) ? b->fields[k->column] : "";
+    if (!*x || !*y) { r = !!*x - !!*y; if (!(set->flags & SHARD_NULLS_FIRST)) r = -r; }
+    else if (k->numeric > 0) { parse_number(x, &u); parse_number(y, &v); r = (u > v) - (u < v); }
+    else r = strcmp(x, y);
+    if (r) return k->descending ? -r : r;
+  }
+  return 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Parse a value of a sort key as a (decimal) number.
+ *   value:  value
+ *   number_ptr:  receives the number
+ * Return Value:  Nonzero if the whole value is a number; otherwise, zero.
+ */
+int parse_number(const char * value, double * number_ptr)
+{
+  size_t n = strlen(value);
+  char * e;
+
+  if (!n || strspn(value, "0123456789+-.eE") != n) return 0;
+  *number_ptr = strtod(value, &e); return !*e;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Keep a row of the sample (see shard_read), in place of any row kept already.
+ *   row:  receives a copy of the row
+ *   fields:  array of field values
+ *   count:  number of fields
+ *   index:  position of the row in the results (by which the sample is put back in order)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * keep_row(struct shard_row * row, char ** fields, int count, long index)
+{
+  size_t n;
+  char * d;
+  int i;
+
+  for (n = 0, i = 0; i < count; ++i) n += sizeof(char *) + strlen(fields[i]) + 1;
+  free(row->fields);
+  if (!(row->fields = malloc(n))) return strerror(errno);
+  for (d = (char *)(row->fields + count), i = 0; i < count; ++i) { strcpy(row->fields[i] = d, fields[i]); d += strlen(d) + 1; }
+  row->count = count; row->index = index;
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compare the positions of two rows of the sample (for qsort).
+ *   a:  pointer to first row
+ *   b:  pointer to second row
+ * Return Value:  Negative if a precedes b, positive if b precedes a, or zero if they are the same.
+ */
+int compare_indexes(const void * a, const void * b)
+{
+  long i = ((const struct shard_row *)a)->index, j = ((const struct shard_row *)b)->index;
+  return (i > j) - (i < j);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Generate a pseudorandom number (using xorshift64*, which is good enough for sampling, and the same on every platform).
+ *   state:  state of the generator (which must be nonzero to begin with)
+ * Return Value:  The next number.
+ */
+unsigned long long random_next(unsigned long long * state)
+{
+  unsigned long long x = *state;
+
+  x ^= x >> 12; x ^= x << 25; x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1DULL;
+}
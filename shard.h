@@ -0,0 +1,127 @@
+/* shard.h - Fan-out of a query across shards (database files or connections) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _SHARD_H_
+#define _SHARD_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include "source.h"  /* (struct) source, SOURCE_MESSAGE_MAX_LENGTH */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define SHARD_MAX 0x40  /* 64 */
+#define SHARD_KEY_MAX 0x10  /* 16 */
+#define SHARD_WORKERS 4  /* default maximum number of shards queried at once */
+#define SHARD_SCAN_MIN 0x10000  /* 65536 (minimum number of rowids in a table for a scan of it to be split) */
+#define SHARD_SAMPLE_MAX 0x2710  /* 10000 (maximum size of a sample) */
+
+/* Flags that can be passed to shard_open (in addition to those passed through to source_open) */
+#define SHARD_NULLS_FIRST 0x100  /* empty values (i.e., nulls) sort before all others in ascending order (as in SQLite) */
+#define SHARD_ORDERED 0x200  /* the results of each shard are read in full, in turn (rather than as they are output) */
+#define SHARD_BINARY 0x400  /* text sorts byte by byte unless it is collated otherwise (as in SQLite) */
+
+/* Means by which the database samples a table (see shard_sample) */
+#define SHARD_SAMPLE_ROWID 1  /* looking up random rowids (SQLite) */
+#define SHARD_SAMPLE_BERNOULLI 2  /* TABLESAMPLE BERNOULLI (PostgreSQL) */
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* A sort key (i.e., a term of the ORDER BY clause), which must be a column of the results (by name or ordinal).  Its collation
+ * is positive if it is collated byte by byte (e.g., COLLATE "C"), negative if it is collated otherwise, or zero if it is not
+ * collated.  Whether its values are compared as numbers (1) or as text (0) is decided from the rows of the shards (-1 until
+ * a value that is not null is read).
+ */
+struct shard_key
+{
+  char * name;
+  int ordinal, descending, collation, column, numeric;
+};
+
+/* How the results of a query on each shard are combined:  merged by sort keys (if there are any; otherwise, concatenated),
+ * with a global offset and limit (-1 if none).  If the query must be rewritten for each shard (i.e., so that each shard
+ * returns enough rows to satisfy the offset), the rewritten query is given; otherwise, query is NULL.
+ */
+struct shard_plan
+{
+  struct shard_key keys[SHARD_KEY_MAX];
+  int key_count;
+  long limit, offset;
+  char * query, * buffer;
+};
+
+/* How a query on a single (SQLite) table is split into rowid ranges, each of which is then queried as a shard (with the
+ * same command line, but its own input).  The results are combined according to the plan, and the given flags.
+ */
+struct shard_scan
+{
+  const char * commands[SHARD_MAX], * input[SHARD_MAX][2], ** inputs[SHARD_MAX];
+  int count, flags;
+  struct shard_plan plan;
+  char * buffer;
+};
+
+/* A row of a sample (see shard_reservoir), and its position in the results. */
+struct shard_row
+{
+  char ** fields;
+  int count;
+  long index;
+};
+
+/* The state of a query on a set of shards.  Each shard has a row source, and at most a given number
+ * of them (workers) are running at once.  The current record is in fields (like that of a row source).  If the results
+ * are sampled, the rows kept so far (of those seen) are in the reservoir, and once every row has been seen, the next to
+ * be read is given by next (which is -1 until then).
+ */
+struct shard_set
+{
+  struct source * sources;
+  const char ** commands, *** inputs;
+  struct shard_plan * plan;
+  int count, workers, flags, started, running, current, last, primed, headed;
+  long limit, offset;
+  char ** fields, ** heading;
+  int field_count, heading_count;
+  struct shard_row * reservoir;
+  long sample, seen, kept, next;
+  unsigned long long seed;
+  char message[SOURCE_MESSAGE_MAX_LENGTH];
+};
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+const char * shard_plan(const char * query, struct shard_plan * plan);
+int shard_scan(const char * command, const char * query, int count, struct shard_scan * scan);
+int shard_sample(const char * command, const char * query, long size, int method, struct shard_scan * scan);
+const char * shard_open(struct shard_set * set, const char ** commands, const char *** inputs,
+                        int count, int workers, int flags, struct shard_plan * plan);
+const char * shard_start(struct shard_set * set);
+const char * shard_reservoir(struct shard_set * set, long size);
+int shard_read(struct shard_set * set);
+const char * shard_close(struct shard_set * set);
+
+
+#endif  /* (prevent multiple inclusion) */
@@ -0,0 +1,197 @@
+/* snapshot.c - Snapshots (materialized results) of template queries for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <sys/stat.h>  /* stat, (struct) stat */
+#include <errno.h>     /* ENAMETOOLONG, errno */
+#include <stdio.h>     /* remove, snprintf, sprintf */
+#include <string.h>    /* memset, strcpy, strerror */
+#include <time.h>      /* time */
+#include "jb.h"        /* jb_file_read, jb_file_write, JB_PATH_MAX_LENGTH */
+#include "job.h"       /* job_detach, job_directory, job_expire, job_lock, job_replace, job_unlock, job_valid */
+#include "output.h"    /* output_close, output_open */
+#include "snapshot.h"  /* (struct) snapshot, SNAPSHOT_FORM, SNAPSHOT_ID_LENGTH, SNAPSHOT_LOCK, SNAPSHOT_OUTPUT,
+                          SNAPSHOT_RETENTION, SNAPSHOT_TEMPORARY */
+
+
+/*************
+ * Constants *
+ *************/
+
+static const char * STR_SNAPSHOT_ID = "Snapshot ID is not valid";
+static const char * STR_DIRECTORY_FORMAT = "%s/dumprows%08lx.snapshots";
+static const char * STR_PATH_FORMAT = "%s/%s%s";
+static const char * STR_OPTION_FORMAT = "--snapshot=%s";
+static const char * STR_FILES[] = { SNAPSHOT_TEMPORARY, SNAPSHOT_OUTPUT, SNAPSHOT_LOCK, SNAPSHOT_FORM, NULL };
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Identify a snapshot (whose files may or may not exist).
+ *   snapshot:  receives the snapshot
+ *   key:  identifies the script file (e.g., a hash of its path), whose snapshots are kept together
+ *   id:  snapshot ID (a hash of the query, as hexadecimal digits)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * snapshot_open(struct snapshot * snapshot, unsigned long key, const char * id)
+{
+  memset(snapshot, 0, sizeof(struct snapshot));
+  snapshot->lock = -1;
+
+  if (!job_valid(id, SNAPSHOT_ID_LENGTH)) return STR_SNAPSHOT_ID;
+  strcpy(snapshot->id, id);
+
+  /* Snapshots are kept in the temporary directory (like jobs). */
+  return job_directory(snapshot->directory, STR_DIRECTORY_FORMAT, key);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Compose the path of one of the files that make up a snapshot.
+ *   snapshot:  snapshot (whose path member receives the path)
+ *   extension:  SNAPSHOT_FORM, SNAPSHOT_LOCK, SNAPSHOT_OUTPUT, or SNAPSHOT_TEMPORARY
+ * Return Value:  The path, or NULL if it is too long.
+ */
+const char * snapshot_path(struct snapshot * snapshot, const char * extension)
+{
+  return (snprintf(snapshot->path, JB_PATH_MAX_LENGTH, STR_PATH_FORMAT, snapshot->directory, snapshot->id, extension)
+          < JB_PATH_MAX_LENGTH) ? snapshot->path : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Determine how old a snapshot is.
+ *   snapshot:  snapshot
+ * Return Value:  The number of seconds since the snapshot was made (or last refreshed), or -1 if it does not exist.
+ */
+long snapshot_age(struct snapshot * snapshot)
+{
+  struct stat st;
+  long n;
+
+  if (!snapshot_path(snapshot, SNAPSHOT_OUTPUT) || stat(snapshot->path, &st)) return -1;
+  return ((n = (long)(time(NULL) - st.st_mtime)) < 0) ? 0 : n;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Keep the form data of a request for a snapshot, with which the snapshot is refreshed.  (This also creates the directory in
+ * which the snapshot is kept, if necessary.)
+ *   snapshot:  snapshot
+ *   form:  decoded form data
+ *   length:  length of decoded form data
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * snapshot_keep(struct snapshot * snapshot, const char * form, size_t length)
+{
+  if (!snapshot_path(snapshot, SNAPSHOT_FORM)) return strerror(ENAMETOOLONG);
+  return jb_file_write(snapshot->path, form, length) ? strerror(errno) : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Lock a snapshot (without waiting), so that no other process makes or refreshes it at the same time.  The lock is a locked
+ * file, which is unlocked by snapshot_unlock (or if the process exits for any reason).
+ *   snapshot:  snapshot (whose lock member receives the descriptor of the lock file)
+ * Return Value:  Nonzero if the snapshot is locked; otherwise (e.g., if another process holds the lock), zero.
+ */
+int snapshot_lock(struct snapshot * snapshot)
+{
+  return snapshot_path(snapshot, SNAPSHOT_LOCK) && (snapshot->lock = job_lock(snapshot->path)) >= 0;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Unlock a snapshot (see snapshot_lock).
+ *   snapshot:  snapshot
+ */
+void snapshot_unlock(struct snapshot * snapshot)
+{
+  job_unlock(snapshot->lock); snapshot->lock = -1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Spawn a process (this program, with the --snapshot option) to refresh a snapshot (with the form data kept by
+ * snapshot_keep), detached from this process (so that neither the web server nor the client waits for it).
+ *   snapshot:  snapshot
+ *   argv:  array of command line arguments (same as argv passed to main)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * snapshot_spawn(struct snapshot * snapshot, char * argv[])
+{
+  char s[SNAPSHOT_ID_LENGTH + 0x10];
+
+  sprintf(s, STR_OPTION_FORMAT, snapshot->id);
+  return job_detach(argv, s);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Begin making (or refreshing) a snapshot:  output is redirected to a temporary file, which replaces the snapshot only when
+ * it is complete (so that the snapshot is never read partially, and remains available meanwhile).
+ *   snapshot:  snapshot (which should be locked)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * snapshot_begin(struct snapshot * snapshot)
+{
+  return snapshot_path(snapshot, SNAPSHOT_TEMPORARY) ? output_open(snapshot->path) : strerror(ENAMETOOLONG);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Finish making (or refreshing) a snapshot (see snapshot_begin).  Output reverts to standard output.  Unless there was an
+ * error, the temporary file replaces the snapshot; otherwise, it is removed (and any previous snapshot remains).
+ *   snapshot:  snapshot
+ *   error:  error message (or NULL if the results are complete)
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * snapshot_end(struct snapshot * snapshot, const char * error)
+{
+  char s[JB_PATH_MAX_LENGTH];
+  const char * p = output_close();
+
+  if (!error) error = p;
+  if (!snapshot_path(snapshot, SNAPSHOT_TEMPORARY)) return error ? error : strerror(ENAMETOOLONG);
+  strcpy(s, snapshot->path);
+  if (error) { remove(s); return error; }
+  if (!snapshot_path(snapshot, SNAPSHOT_OUTPUT)) { remove(s); return strerror(ENAMETOOLONG); }
+  if (p = job_replace(s, snapshot->path)) { remove(s); return p; }
+
+  /* Snapshots that have not been made or refreshed for SNAPSHOT_RETENTION seconds (which are no longer requested, or whose
+   * queries are no longer valid) are removed.
+   */
+  job_expire(snapshot->directory, SNAPSHOT_FORM, SNAPSHOT_ID_LENGTH, SNAPSHOT_RETENTION, STR_FILES);
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the form data kept for a snapshot (see snapshot_keep).
+ *   snapshot:  snapshot
+ *   size_ptr:  receives the length of the form data
+ * Return Value:  The form data (null-terminated, which should be freed with free), or NULL if there is none.
+ */
+char * snapshot_read(struct snapshot * snapshot, size_t * size_ptr)
+{
+  struct stat st;
+  char * p;
+
+  if (!snapshot_path(snapshot, SNAPSHOT_FORM) || stat(snapshot->path, &st) || !(p = jb_file_read(snapshot->path, st.st_size)))
+    return NULL;
+  p[*size_ptr = st.st_size] = '\0';
+  return p;
+}
@@ -0,0 +1,68 @@
+/* snapshot.h - Snapshots (materialized results) of template queries for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include <stddef.h>  /* size_t */
+#include "jb.h"      /* JB_PATH_MAX_LENGTH */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define SNAPSHOT_ID_LENGTH 0x10  /* 16 */
+#define SNAPSHOT_RETENTION 604800  /* number of seconds that a snapshot is kept unless refreshed (one week) */
+
+/* Files that make up a snapshot (named for the snapshot, with these extensions) */
+#define SNAPSHOT_FORM ".form"  /* form data of a request for the snapshot (with which it is refreshed) */
+#define SNAPSHOT_LOCK ".lock"  /* locked while the snapshot is being made or refreshed */
+#define SNAPSHOT_OUTPUT ".out"  /* results (newline-delimited JSON, as streamed) */
+#define SNAPSHOT_TEMPORARY ".tmp"  /* results of a refresh in progress */
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* A snapshot, which is kept (as files named for its ID, a hash of the query) in a directory named for the script file. */
+struct snapshot
+{
+  char id[SNAPSHOT_ID_LENGTH + 1], directory[JB_PATH_MAX_LENGTH], path[JB_PATH_MAX_LENGTH];
+  int lock;
+};
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+const char * snapshot_open(struct snapshot * snapshot, unsigned long key, const char * id);
+const char * snapshot_path(struct snapshot * snapshot, const char * extension);
+long snapshot_age(struct snapshot * snapshot);
+const char * snapshot_keep(struct snapshot * snapshot, const char * form, size_t length);
+int snapshot_lock(struct snapshot * snapshot);
+void snapshot_unlock(struct snapshot * snapshot);
+const char * snapshot_spawn(struct snapshot * snapshot, char * argv[]);
+const char * snapshot_begin(struct snapshot * snapshot);
+const char * snapshot_end(struct snapshot * snapshot, const char * error);
+char * snapshot_read(struct snapshot * snapshot, size_t * size_ptr);
+
+
+#endif  /* (prevent multiple inclusion) */
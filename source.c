@@ -0,0 +1,365 @@
+/* source.c - Row source (database utility output) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#ifdef _WIN32
+/* This eliminates deprecation warnings for functions that are considered "unsafe" (and would
+ * result in error C4996) on Win32, thus allowing us to write simpler, more portable code.
+ */
+#define _CRT_SECURE_NO_WARNINGS
+#else
+/* This exposes fdopen, mkstemp, pclose, and popen. */
+#define _GNU_SOURCE
+#endif
+
+#include <ctype.h>       /* isspace */
+#include <errno.h>       /* EBADF, ENAMETOOLONG, errno */
+#ifdef _WIN32
+#  include <io.h>        /* _fileno, _read */
+#endif
+#include <stdio.h>       /* fclose, fdopen, ferror, fileno, FILE, fopen, fputs, fread, pclose/_pclose, popen/_popen, remove,
+                            snprintf, sprintf */
+#include <stdlib.h>      /* free, getenv, malloc, mkstemp, realloc, _tempnam */
+#include <string.h>      /* memcmp, memcpy, memmove, memset, strcpy, strerror, strlen, strncmp */
+#ifndef _WIN32
+#  include <sys/wait.h>  /* WEXITSTATUS, WIFEXITED */
+#  include <unistd.h>    /* read */
+#endif
+#include "output.h"      /* output_flush */
+#include "source.h"      /* (struct) source, SOURCE_FLUSH, SOURCE_MESSAGE_MAX_LENGTH, SOURCE_SPOOL, SOURCE_SQLPLUS */
+
+
+/*************
+ * Constants *
+ *************/
+
+static const char * STR_COMMAND_FORMAT = "%s < \"%s\" 2> \"%s\"";
+static const char * STR_SPOOL_FORMAT = "%s < \"%s\" > \"%s\" 2> \"%s\"";
+static const char * STR_STATUS_FORMAT = "Database utility exited with status %d";
+
+/* SQL*Plus reports an error on standard output, beginning with one of these. */
+static const char * STR_SQLPLUS_ERRORS[] = { "ERROR", "ORA-", "SP2-", NULL };
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+#define SOURCE_BUFFER_SIZE 0x10000  /* 65536 */
+#define SOURCE_FIELD_COUNT 0x20  /* 32 */
+
+/* The pipe is read directly (rather than via the stream's buffer), so that whatever the utility has output can be
+ * processed immediately, without waiting for the buffer to fill.
+ */
+#ifdef _WIN32
+#  define read_pipe(stream, buffer, count) _read(_fileno(stream), buffer, (unsigned int)(count))
+#else
+#  define read_pipe(stream, buffer, count) read(fileno(stream), buffer, count)
+#endif
+
+
+/*********************************
+ * Private Function Declarations *
+ *********************************/
+
+FILE * create_temp(char * path);
+int close_process(FILE * stream);
+const char * read_error(struct source * source);
+int read_message(struct source * source, const char * begin);
+
+
+/*************
+ * Functions *
+ *************/
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Spawn a database utility to execute a query, such that its standard output can be read one (CSV) record at a time.
+ * Whether or not this succeeds, source_close should be called (to delete temporary files and free memory).
+ *   source:  receives the state of the row source
+ *   command:  command line (which should invoke a database utility)
+ *   input:  array of strings (terminated by NULL) that constitute the utility's standard input (i.e., the query)
+ *   flags:  zero, or any combination of SOURCE_FLUSH, SOURCE_SPOOL, and SOURCE_SQLPLUS
+ * Return Value:  NULL on success; otherwise, an error message.
+ */
+const char * source_open(struct source * source, const char * command, const char * input[], int flags)
+{
+  FILE * f;
+  char * s;
+  int i, n;
+
+  memset(source, 0, sizeof(struct source));
+  source->flags = flags;
+
+  /* Write the input to a temporary file, and create another (empty) temporary file to receive standard error.
+   * (Redirecting both, rather than writing to a pipe, allows standard output to be read while the utility runs.)
+   */
+  if (!(f = create_temp(source->input_path))) return strerror(errno);
+  for (i = 0; input[i]; ++i) fputs(input[i], f);
+  n = ferror(f); if (fclose(f) || n) return strerror(errno);
+  if (!(f = create_temp(source->error_path))) return strerror(errno);
+  if (fclose(f)) return strerror(errno);
+  if (flags & SOURCE_SPOOL)
+  {
+    if (!(f = create_temp(source->output_path))) return strerror(errno);
+    if (fclose(f)) return strerror(errno);
+  }
+
+  /* Allocate memory for the command line (with redirection) and the record buffer. */
+  if (!(s = malloc(strlen(command) + 3 * JB_PATH_MAX_LENGTH + 0x10))) return strerror(errno);
+  if (flags & SOURCE_SPOOL) sprintf(s, STR_SPOOL_FORMAT, command, source->input_path, source->output_path, source->error_path);
+  else sprintf(s, STR_COMMAND_FORMAT, command, source->input_path, source->error_path);
+  if (!(source->buffer = malloc((source->size = SOURCE_BUFFER_SIZE) + 1))) { free(s); return strerror(errno); }
+  source->begin = source->scan = source->end = source->buffer;
+
+  /* Execute the command line, creating a pipe between this process and the child process.  The readable end of
+   * the pipe is associated with the resulting stream, and the writable end with the child's standard output.
+   * (If the output is spooled, nothing is written to the pipe, which serves only to wait for the child to exit.)
+   */
+#ifdef _WIN32
+  source->process = _popen(s, "rb");
+#else
+  source->process = popen(s, "r");
+#endif
+  free(s);
+  if (!source->process) return strerror(errno);
+  if (!(flags & SOURCE_SPOOL)) source->stream = source->process;
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the next (CSV) record from a database utility's standard output.  Fields are unquoted in place, and remain valid
+ * until the next call.  The first record is the column headings.
+ *   source:  state of the row source
+ * Return Value:  On success, the number of fields in the record (which are in the fields member of source);
+ *   zero if there are no more records; or -1 on error (in which case source_close returns the error message).
+ */
+int source_read(struct source * source)
+{
+  char * p, * d, * e, * r;
+  size_t n;
+  int q, k;
+
+  /* If the output is spooled, it can only be read once the utility exits. */
+  if (!source->stream && source_wait(source)) return -1;
+
+  for (;;)
+  {
+    /* Scan for the end of the record (a newline that is not within a quoted field). */
+    for (p = source->scan, q = source->quoted; p < source->end; ++p)
+    {
+      if (*p == '"') q = !q;
+      else if (*p == '\n' && !q) break;
+    }
+    if (p < source->end || (source->eof && p > source->begin))
+    {
+      /* Trim the carriage return (if any) from the end of the record, and note where the next record begins. */
+      r = (p < source->end) ? p + 1 : p;
+      if (p > source->begin && p[-1] == '\r') --p;
+
+      /* SQL*Plus writes errors (rather than records) to standard output, repeats the column headings
+       * on each page, and separates pages with blank lines.  Repeated headings and blank lines are skipped.
+       */
+      if (source->flags & SOURCE_SQLPLUS)
+      {
+        n = p - source->begin;
+        if (n && !source->record_count)
+        {
+          for (q = 0; STR_SQLPLUS_ERRORS[q]; ++q)
+            if (n >= strlen(STR_SQLPLUS_ERRORS[q]) && !strncmp(source->begin, STR_SQLPLUS_ERRORS[q], strlen(STR_SQLPLUS_ERRORS[q])))
+              return read_message(source, source->begin);
+          if (!(source->heading = malloc(n + 1))) { strcpy(source->message, strerror(errno)); return -1; }
+          memcpy(source->heading, source->begin, n); source->heading[n] = '\0';
+        }
+        else if (!n || (n == strlen(source->heading) && !memcmp(source->begin, source->heading, n)))
+        {
+          source->begin = source->scan = r; source->quoted = 0; continue;
+        }
+      }
+      break;
+    }
+    if (source->eof) return 0;
+    source->scan = p; source->quoted = q;
+
+    /* The record is incomplete, so move it to the beginning of the buffer (or, if it already
+     * occupies the whole buffer, enlarge the buffer), and read more of the utility's output.
+     */
+    if (source->begin > source->buffer)
+    {
+      memmove(source->buffer, source->begin, n = source->end - source->begin);
+      source->scan -= source->begin - source->buffer; source->end = source->buffer + n; source->begin = source->buffer;
+    }
+    else if (source->end == source->buffer + source->size)
+    {
+      if (!(d = realloc(source->buffer, 2 * source->size + 1))) { strcpy(source->message, strerror(errno)); return -1; }
+      source->scan = d + (source->scan - source->buffer); source->end = d + source->size;
+      source->begin = source->buffer = d; source->size *= 2;
+    }
+    if (source->flags & SOURCE_FLUSH) output_flush();
+    if ((k = read_pipe(source->stream, source->end, source->buffer + source->size - source->end)) < 0)
+      { strcpy(source->message, strerror(errno)); return -1; }
+    if (!k) source->eof = 1;
+    source->end += k;
+  }
+
+  /* Split the record into fields, unquoting each in place (a doubled quote within a quoted field is a literal quote). */
+  for (e = p, p = d = source->begin, q = 0;; ++p)
+  {
+    if (q == source->field_max)
+    {
+      if (!(source->fields = realloc(source->fields, (source->field_max += SOURCE_FIELD_COUNT) * sizeof(char *))))
+        { strcpy(source->message, strerror(errno)); return -1; }
+    }
+    source->fields[q++] = d;
+    if (p < e && *p == '"')
+      for (++p; p < e; *d++ = *p++) if (*p == '"' && (++p == e || *p != '"')) break;
+    while (p < e && *p != ',') *d++ = *p++;
+    *d++ = '\0';
+    if (p == e) break;
+  }
+
+  source->begin = source->scan = r; source->quoted = 0;
+  ++source->record_count;
+  return source->field_count = q;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Wait for a database utility whose output is spooled to exit, and open the spooled output for reading.  (This is
+ * done by source_read as needed, but can be done beforehand to control how many utilities are running at once.)
+ *   source:  state of the row source
+ * Return Value:  NULL on success; otherwise, an error message (e.g., as written by the utility to standard error).
+ */
+const char * source_wait(struct source * source)
+{
+  const char * p;
+
+  if (source->stream) return NULL;
+  if (!source->process) { strcpy(source->message, strerror(EBADF)); return source->message; }
+  source->status = close_process(source->process); source->process = NULL;
+  if (p = read_error(source)) return p;
+  if (!(source->stream = fopen(source->output_path, "rb"))) { strcpy(source->message, strerror(errno)); return source->message; }
+  return NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Wait for a database utility to exit (if it hasn't already), delete the temporary files, and free memory.
+ *   source:  state of the row source
+ * Return Value:  NULL on success; otherwise, an error message (e.g., as written by the utility to standard error).
+ */
+const char * source_close(struct source * source)
+{
+  /* If the output was abandoned before the end (which the utility may not survive), its exit status is immaterial. */
+  if (source->process)
+  {
+    source->status = close_process(source->process);
+    if (source->eof || source->stream != source->process) read_error(source);
+  }
+  if (source->stream && source->stream != source->process) fclose(source->stream);
+  source->process = source->stream = NULL;
+
+  if (source->error_path[0]) remove(source->error_path);
+  if (source->output_path[0]) remove(source->output_path);
+  if (source->input_path[0]) remove(source->input_path);
+
+  free(source->buffer); free(source->fields); free(source->heading);
+  source->buffer = NULL; source->fields = NULL; source->heading = NULL;
+  return source->message[0] ? source->message : NULL;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Create a temporary file (in the directory named by TMPDIR on Linux, or TMP on Win32).
+ *   path:  receives pathname of file
+ * Return Value:  Pointer to file (opened for writing), or NULL on error.
+ */
+FILE * create_temp(char * path)
+{
+#ifdef _WIN32
+  char * p;
+
+  if (!(p = _tempnam(NULL, "dumprows"))) return NULL;
+  if (strlen(p) >= JB_PATH_MAX_LENGTH) { free(p); errno = ENAMETOOLONG; return NULL; }
+  strcpy(path, p); free(p);
+  return fopen(path, "w");
+#else
+  const char * p = getenv("TMPDIR");
+  int d;
+
+  if (!p || !*p) p = "/tmp";
+  if (snprintf(path, JB_PATH_MAX_LENGTH, "%s/dumprowsXXXXXX", p) >= JB_PATH_MAX_LENGTH) { errno = ENAMETOOLONG; path[0] = '\0'; return NULL; }
+  if ((d = mkstemp(path)) < 0) { path[0] = '\0'; return NULL; }
+  return fdopen(d, "w");
+#endif
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Wait for a database utility to exit, and close the stream associated with its pipe.
+ *   stream:  stream returned by popen
+ * Return Value:  The utility's exit status, or -1 on error.
+ */
+int close_process(FILE * stream)
+{
+  int i;
+
+#ifdef _WIN32
+  i = _pclose(stream);
+#else
+  if ((i = pclose(stream)) > 0 && WIFEXITED(i)) i = WEXITSTATUS(i);
+#endif
+  return i;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * If a database utility failed (and no error has been noted already), read its standard error, which should explain why.
+ *   source:  state of the row source
+ * Return Value:  NULL if the utility succeeded; otherwise, an error message.
+ */
+const char * read_error(struct source * source)
+{
+  FILE * f;
+  size_t n;
+
+  if (!source->status || source->message[0]) return source->message[0] ? source->message : NULL;
+  if (f = fopen(source->error_path, "r"))
+  {
+    n = fread(source->message, 1, SOURCE_MESSAGE_MAX_LENGTH - 1, f);
+    source->message[n] = '\0';
+    fclose(f);
+  }
+  for (n = strlen(source->message); n && isspace((unsigned char)source->message[n - 1]); --n) source->message[n - 1] = '\0';
+  if (!n) sprintf(source->message, STR_STATUS_FORMAT, source->status);
+  return source->message;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ * Read the rest of a database utility's standard output as an error message.
+ *   source:  state of the row source
+ *   begin:  beginning of message (within the record buffer)
+ * Return Value:  -1 (for convenience, as source_read returns this on error).
+ */
+int read_message(struct source * source, const char * begin)
+{
+  size_t n = source->end - begin;
+  int k;
+
+  if (n >= SOURCE_MESSAGE_MAX_LENGTH) n = SOURCE_MESSAGE_MAX_LENGTH - 1;
+  memcpy(source->message, begin, n);
+  if (!source->eof)
+    for (; n < SOURCE_MESSAGE_MAX_LENGTH - 1; n += k)
+      if ((k = read_pipe(source->stream, source->message + n, SOURCE_MESSAGE_MAX_LENGTH - 1 - n)) <= 0) break;
+  source->message[n] = '\0';
+
+  /* Trim trailing whitespace (e.g., the blank line that follows the message). */
+  while (n && isspace((unsigned char)source->message[n - 1])) source->message[--n] = '\0';
+  return -1;
+}
@@ -0,0 +1,70 @@
+/* source.h - Row source (database utility output) for DUMPROWS
+ *
+ * Copyright (c) 2021-3 Jeffrey Paul Bourdier
+ *
+ * Licensed under the MIT License.  This file may be used only in compliance with this License.
+ * Software distributed under this License is provided "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ * For more information, see the accompanying License file or the following URL:
+ *
+ *   https://opensource.org/licenses/MIT
+ */
+
+
+/* Prevent multiple inclusion. */
+#ifndef _SOURCE_H_
+#define _SOURCE_H_
+
+
+/*****************
+ * Include Files *
+ *****************/
+
+#include <stdio.h>  /* FILE */
+#include "jb.h"     /* JB_PATH_MAX_LENGTH */
+
+
+/*********************
+ * Macro Definitions *
+ *********************/
+
+/* Flags that can be passed to source_open */
+#define SOURCE_SQLPLUS 0x1  /* output is from SQL*Plus (which reports errors on standard output and repeats headings) */
+#define SOURCE_FLUSH 0x2  /* standard output is flushed whenever more of the utility's output must be awaited */
+#define SOURCE_SPOOL 0x4  /* output is written to a temporary file, and read (by source_read) once the utility exits */
+
+#define SOURCE_MESSAGE_MAX_LENGTH 0x400  /* 1024 */
+
+
+/**************************
+ * Structure Declarations *
+ **************************/
+
+/* A database utility spawned to execute a query, whose standard output (in CSV format) is read one record at a time.
+ * The input (i.e., the query) is written to a temporary file, as is the utility's standard error.  Standard output
+ * is read from a pipe (in which case process and stream are the same), or else spooled to a temporary file.
+ */
+struct source
+{
+  FILE * process, * stream;
+  char input_path[JB_PATH_MAX_LENGTH], output_path[JB_PATH_MAX_LENGTH], error_path[JB_PATH_MAX_LENGTH];
+  char * buffer, * begin, * scan, * end, ** fields, * heading;
+  size_t size;
+  int flags, status, quoted, eof, field_count, field_max, record_count;
+  char message[SOURCE_MESSAGE_MAX_LENGTH];
+};
+
+/* Determine whether or not any of the utility's output remains to be parsed (without waiting for more). */
+#define source_buffered(source) ((source)->begin < (source)->end)
+
+
+/*************************
+ * Function Declarations *
+ *************************/
+
+const char * source_open(struct source * source, const char * command, const char * input[], int flags);
+int source_read(struct source * source);
+const char * source_wait(struct source * source);
+const char * source_close(struct source * source);
+
+
+#endif  /* (prevent multiple inclusion) */